@@ -0,0 +1,97 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__ASYNC_RELIABLE_H_
+#define RMW_MICROROS__ASYNC_RELIABLE_H_
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Sets the asynchronous reliable mode of a publisher.
+ *        In this mode `rmw_publish` returns as soon as the sample is written to the reliable
+ *        output stream, instead of waiting for its delivery confirmation.
+ *        Acknowledgements are processed whenever the session runs, as in `rmw_wait`.
+ *        Publishing only blocks when the stream history is full.
+ * \param[in] publisher publisher whose mode is being configured
+ * \param[in] enable true to publish asynchronously, false to wait for delivery on each sample
+ * \return RMW_RET_OK If the mode has been set.
+ * \return RMW_RET_INVALID_ARGUMENT If the publisher is not valid.
+ */
+rmw_ret_t rmw_uros_set_publisher_async_reliable(
+  rmw_publisher_t * publisher,
+  bool enable);
+
+/**
+ * \brief Sets the asynchronous reliable mode of a client.
+ *        In this mode `rmw_send_request` does not wait for the delivery confirmation.
+ * \param[in] client client whose mode is being configured
+ * \param[in] enable true to send requests asynchronously
+ * \return RMW_RET_OK If the mode has been set.
+ * \return RMW_RET_INVALID_ARGUMENT If the client is not valid.
+ */
+rmw_ret_t rmw_uros_set_client_async_reliable(
+  rmw_client_t * client,
+  bool enable);
+
+/**
+ * \brief Sets the asynchronous reliable mode of a service.
+ *        In this mode `rmw_send_response` does not wait for the delivery confirmation.
+ * \param[in] service service whose mode is being configured
+ * \param[in] enable true to send responses asynchronously
+ * \return RMW_RET_OK If the mode has been set.
+ * \return RMW_RET_INVALID_ARGUMENT If the service is not valid.
+ */
+rmw_ret_t rmw_uros_set_service_async_reliable(
+  rmw_service_t * service,
+  bool enable);
+
+/**
+ * \brief Returns the samples of an asynchronous reliable publisher not yet acknowledged.
+ *        Acknowledgements are known for the whole session: samples are counted until every
+ *        reliable output stream of the session is confirmed.
+ *        The session is polled once without waiting, so incoming samples may be received.
+ * \param[in] publisher publisher being queried
+ * \param[out] in_flight_samples number of samples waiting for acknowledgement
+ * \param[out] unacked_bytes serialized size of those samples
+ * \return RMW_RET_OK If the counters have been filled.
+ * \return RMW_RET_INVALID_ARGUMENT If the publisher or any output is not valid.
+ */
+rmw_ret_t rmw_uros_get_publisher_in_flight(
+  const rmw_publisher_t * publisher,
+  size_t * in_flight_samples,
+  size_t * unacked_bytes);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__ASYNC_RELIABLE_H_
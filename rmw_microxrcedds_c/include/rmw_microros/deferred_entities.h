@@ -0,0 +1,70 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__DEFERRED_ENTITIES_H_
+#define RMW_MICROROS__DEFERRED_ENTITIES_H_
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Defers the creation of entities on a context.
+ *        Until the creation is committed, nodes, publishers, subscriptions, services and
+ *        clients take their local resources and buffer their requests to the agent without
+ *        waiting for them. Requests are only sent earlier if the creation stream fills up.
+ *        Entities can not be used until the creation is committed.
+ * \param[in] context context whose entity creation is deferred
+ * \return RMW_RET_OK If the creation has been deferred.
+ * \return RMW_RET_INVALID_ARGUMENT If the context is not valid.
+ * \return RMW_RET_ERROR If the creation is already deferred.
+ */
+rmw_ret_t rmw_uros_defer_entities(
+  rmw_context_t * context);
+
+/**
+ * \brief Sends the requests buffered since `rmw_uros_defer_entities` in one burst and
+ *        waits for the status of all of them at once.
+ *        If any of them fails, the error message names it and the entities created by the
+ *        burst are deleted in the agent. Their handles must still be destroyed.
+ * \param[in] context context whose entity creation is committed
+ * \return RMW_RET_OK If every deferred entity has been created.
+ * \return RMW_RET_INVALID_ARGUMENT If the context is not valid.
+ * \return RMW_RET_ERROR If the creation was not deferred or any request failed or timed out.
+ */
+rmw_ret_t rmw_uros_commit_entities(
+  rmw_context_t * context);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__DEFERRED_ENTITIES_H_
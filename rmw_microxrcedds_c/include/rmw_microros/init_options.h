@@ -19,6 +19,8 @@
 #ifndef RMW_MICROROS__INIT_OPTIONS_H_
 #define RMW_MICROROS__INIT_OPTIONS_H_
 
+#include <stddef.h>
+
 #include <rmw/rmw.h>
 #include <rmw/ret_types.h>
 #include <rmw/init_options.h>
@@ -87,6 +89,53 @@ rmw_ret_t rmw_uros_options_set_client_key(
   uint32_t client_key,
   rmw_init_options_t * rmw_options);
 
+/**
+ * \brief Number of elements of each entity pool carved from a memory arena.
+ */
+typedef struct rmw_uros_memory_arena_counts_t
+{
+  /// Contexts, one per rmw_init.
+  size_t sessions;
+  size_t nodes;
+  size_t publishers;
+  size_t subscriptions;
+  size_t services;
+  size_t clients;
+  /// Topics, 0 for one per publisher and subscription.
+  size_t topics;
+  /// Received samples of the maximum size queued at once, at least one.
+  size_t history;
+} rmw_uros_memory_arena_counts_t;
+
+/**
+ * \brief Returns the bytes of memory arena needed for the given pool sizes.
+ *
+ * \param[in] counts Number of elements of each pool.
+ * \return Size in bytes of the memory arena, 0 if counts is NULL.
+ */
+size_t rmw_uros_memory_arena_size(
+  const rmw_uros_memory_arena_counts_t * counts);
+
+/**
+ * \brief Makes rmw_init carve all entity pools out of a user-provided buffer,
+ *        instead of using the static pools sized by the `RMW_UXRCE_MAX_*` values.
+ *        Pools are set up once by the first rmw_init and are never resized afterwards.
+ *        The buffer must outlive every context and be aligned as a `uint64_t`.
+ *
+ * \param[in] buffer Memory arena.
+ * \param[in] size Size in bytes of the buffer, see rmw_uros_memory_arena_size.
+ * \param[in] counts Number of elements of each pool.
+ * \param[in,out] rmw_options Updated options with rmw specifics.
+ * \return RMW_RET_OK If the arena has been set in rmw_init_options.
+ * \return RMW_RET_INVALID_ARGUMENT If rmw_init_options is not valid, the buffer is misaligned
+ *         or too small, or no session or history is requested.
+ */
+rmw_ret_t rmw_uros_init_options_set_memory_arena(
+  void * buffer,
+  size_t size,
+  const rmw_uros_memory_arena_counts_t * counts,
+  rmw_init_options_t * rmw_options);
+
 /** @}*/
 
 #if defined(__cplusplus)
@@ -0,0 +1,79 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__LOANED_MESSAGES_H_
+#define RMW_MICROROS__LOANED_MESSAGES_H_
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Sets the pool of messages lent by a publisher.
+ *        Once set, `rmw_borrow_loaned_message` hands out messages of this pool and
+ *        `rmw_publish_loaned_message` serializes them straight into the XRCE output stream,
+ *        without any intermediate copy or allocation.
+ *        The pool must be kept alive until it is replaced or the publisher is destroyed.
+ * \param[in] publisher publisher whose loan pool is being configured
+ * \param[in] messages array of `count` messages of the publisher type, NULL to disable loans
+ * \param[in] message_size size in bytes of each message of the array
+ * \param[in] count number of messages in the array, up to 32
+ * \return RMW_RET_OK If the loan pool has been set.
+ * \return RMW_RET_INVALID_ARGUMENT If the publisher or the pool is not valid.
+ * \return RMW_RET_ERROR If messages of the previous pool are still lent.
+ */
+rmw_ret_t rmw_uros_set_publisher_loan_pool(
+  rmw_publisher_t * publisher,
+  void * messages,
+  size_t message_size,
+  size_t count);
+
+/**
+ * \brief Enables loaned messages on a subscription for plain-old-data message types.
+ *        Each received sample reserves `message_size` extra bytes in its static input buffer.
+ *        `rmw_take_loaned_message` deserializes the sample into that space and lends it
+ *        in place, without a user provided message. The static input buffer is held until
+ *        the message is given back with `rmw_return_loaned_message_from_subscription`.
+ *        The lent message is zeroed before deserializing into it, so samples of types with
+ *        sequence or string members that need memory fail to be taken.
+ * \param[in] subscription subscription where loans are being configured
+ * \param[in] message_size size in bytes of a message of the subscription type, 0 to disable loans
+ * \return RMW_RET_OK If the loan size has been set.
+ * \return RMW_RET_INVALID_ARGUMENT If the subscription is not valid.
+ * \return RMW_RET_ERROR If samples are still lent or pending to be taken.
+ */
+rmw_ret_t rmw_uros_set_subscription_loan_size(
+  rmw_subscription_t * subscription,
+  size_t message_size);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__LOANED_MESSAGES_H_
@@ -0,0 +1,87 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__MEMORY_STATISTICS_H_
+#define RMW_MICROROS__MEMORY_STATISTICS_H_
+
+#include <stddef.h>
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Entity pools of the RMW.
+ */
+typedef enum rmw_uros_memory_pool_t
+{
+  RMW_UROS_MEMORY_POOL_SESSIONS,
+  RMW_UROS_MEMORY_POOL_NODES,
+  RMW_UROS_MEMORY_POOL_PUBLISHERS,
+  RMW_UROS_MEMORY_POOL_SUBSCRIPTIONS,
+  RMW_UROS_MEMORY_POOL_SERVICES,
+  RMW_UROS_MEMORY_POOL_CLIENTS,
+  RMW_UROS_MEMORY_POOL_TOPICS
+} rmw_uros_memory_pool_t;
+
+/**
+ * \brief Usage of an entity pool.
+ */
+typedef struct rmw_uros_memory_statistics_t
+{
+  /// Elements in the pool, static and dynamically allocated.
+  size_t capacity;
+  /// Elements currently in use.
+  size_t used;
+  /// Maximum number of elements used at once.
+  size_t high_water;
+  /// Chunks of `RMW_UXRCE_DYNAMIC_POOL_CHUNK` elements allocated from the heap.
+  size_t dynamic_allocations;
+  /// Chunks given back to the heap.
+  size_t dynamic_frees;
+} rmw_uros_memory_statistics_t;
+
+/**
+ * \brief Returns the usage of an entity pool.
+ *        The high water mark helps sizing the static pools, and the dynamic counters
+ *        show heap traffic when `RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS` is enabled.
+ * \param[in] pool pool to inspect
+ * \param[out] statistics usage of the pool
+ * \return RMW_RET_OK If the statistics have been returned.
+ * \return RMW_RET_INVALID_ARGUMENT If the pool is not valid or statistics is NULL.
+ */
+rmw_ret_t rmw_uros_get_memory_statistics(
+  rmw_uros_memory_pool_t pool,
+  rmw_uros_memory_statistics_t * statistics);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__MEMORY_STATISTICS_H_
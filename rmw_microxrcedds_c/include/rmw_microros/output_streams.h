@@ -0,0 +1,59 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__OUTPUT_STREAMS_H_
+#define RMW_MICROROS__OUTPUT_STREAMS_H_
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Moves a publisher to another output stream of its session.
+ *        Reliable publishers choose among `RMW_UXRCE_RELIABLE_OUTPUT_STREAMS` streams and
+ *        best effort ones among `RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS`. Stream 0 is the default
+ *        one, shared with clients, services and entity creation.
+ *        Publishers on different reliable streams do not wait for each other's samples,
+ *        so a large fragmented sample does not delay small samples of another stream.
+ * \param[in] publisher publisher being moved
+ * \param[in] index index of the output stream among the streams of its reliability kind
+ * \return RMW_RET_OK If the publisher has been moved.
+ * \return RMW_RET_INVALID_ARGUMENT If the publisher or the index is not valid.
+ * \return RMW_RET_ERROR If the publisher still has samples waiting for acknowledgement.
+ */
+rmw_ret_t rmw_uros_set_publisher_output_stream(
+  rmw_publisher_t * publisher,
+  size_t index);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__OUTPUT_STREAMS_H_
@@ -0,0 +1,96 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__PRIORITY_H_
+#define RMW_MICROROS__PRIORITY_H_
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Assigns a publisher to one of the `RMW_UXRCE_PRIORITY_CLASSES` priority classes,
+ *        0 being the highest and the default one.
+ *        The publisher is moved to the output stream of the same index, or to the last stream
+ *        of its reliability kind if there are fewer streams than classes.
+ *        Classes only rate limit their publishers with `rmw_uros_set_priority_budget`:
+ *        output streams are flushed together, so a class never goes on the link ahead of
+ *        another one. With the default single output stream of each kind all classes share it.
+ * \param[in] publisher publisher being assigned
+ * \param[in] priority priority class
+ * \return RMW_RET_OK If the priority class has been assigned.
+ * \return RMW_RET_INVALID_ARGUMENT If the publisher or the priority class is not valid.
+ * \return RMW_RET_ERROR If the publisher still has samples waiting for acknowledgement.
+ */
+rmw_ret_t rmw_uros_set_publisher_priority(
+  rmw_publisher_t * publisher,
+  size_t priority);
+
+/**
+ * \brief Limits the bandwidth used by the publishers of a priority class, so that they cannot
+ *        saturate a slow link needed by higher priority classes.
+ *        Over the budget, best effort samples are dropped while `rmw_publish` still returns
+ *        RMW_RET_OK, they are counted by `rmw_uros_get_priority_usage`.
+ *        Reliable publications wait up to `RMW_UXRCE_PUBLISH_RELIABLE_TIMEOUT` ms for the budget
+ *        to refill without running the session, then fail with RMW_RET_TIMEOUT.
+ *        Bursts up to 100 ms of budget are allowed.
+ * \param[in] context context owning the session
+ * \param[in] priority priority class
+ * \param[in] bytes_per_second serialized payload bytes allowed per second, 0 for no limit
+ * \return RMW_RET_OK If the budget has been set.
+ * \return RMW_RET_INVALID_ARGUMENT If the context or the priority class is not valid.
+ */
+rmw_ret_t rmw_uros_set_priority_budget(
+  rmw_context_t * context,
+  size_t priority,
+  size_t bytes_per_second);
+
+/**
+ * \brief Returns the serialized payload bytes sent and the samples dropped by a priority class
+ *        since its budget was last set.
+ * \param[in] context context owning the session
+ * \param[in] priority priority class
+ * \param[out] sent_bytes bytes sent, can be NULL
+ * \param[out] dropped_samples samples dropped over the budget, can be NULL
+ * \return RMW_RET_OK If the usage has been returned.
+ * \return RMW_RET_INVALID_ARGUMENT If the context or the priority class is not valid.
+ */
+rmw_ret_t rmw_uros_get_priority_usage(
+  rmw_context_t * context,
+  size_t priority,
+  size_t * sent_bytes,
+  size_t * dropped_samples);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__PRIORITY_H_
@@ -0,0 +1,66 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__PUBLISH_BATCH_H_
+#define RMW_MICROROS__PUBLISH_BATCH_H_
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Opens a publish batch on a context.
+ *        Until the batch is closed, publications of every publisher of the context are
+ *        written to the output streams without being flushed, so consecutive samples share
+ *        transport packets. Reliable publications do not wait for delivery confirmation.
+ * \param[in] context context whose publications are batched
+ * \return RMW_RET_OK If the batch has been opened.
+ * \return RMW_RET_INVALID_ARGUMENT If the context is not valid.
+ * \return RMW_RET_ERROR If a batch is already open.
+ */
+rmw_ret_t rmw_uros_begin_publish_batch(
+  rmw_context_t * context);
+
+/**
+ * \brief Closes the publish batch of a context and flushes its output streams.
+ *        If reliable samples were published in the batch, waits for their delivery.
+ * \param[in] context context whose publish batch is closed
+ * \return RMW_RET_OK If the batch has been sent.
+ * \return RMW_RET_INVALID_ARGUMENT If the context is not valid.
+ * \return RMW_RET_ERROR If no batch is open or reliable delivery is not confirmed.
+ */
+rmw_ret_t rmw_uros_end_publish_batch(
+  rmw_context_t * context);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__PUBLISH_BATCH_H_
@@ -22,9 +22,17 @@
 #include <rmw/init_options.h>
 
 #include <rmw_microros/continous_serialization.h>
+#include <rmw_microros/loaned_messages.h>
+#include <rmw_microros/publish_batch.h>
+#include <rmw_microros/async_reliable.h>
+#include <rmw_microros/output_streams.h>
+#include <rmw_microros/priority.h>
+#include <rmw_microros/deferred_entities.h>
+#include <rmw_microros/memory_statistics.h>
 #include <rmw_microros/init_options.h>
 #include <rmw_microros/time_sync.h>
 #include <rmw_microros/ping.h>
+#include <rmw_microros/zero_copy.h>
 
 #ifdef RMW_UXRCE_TRANSPORT_UDP
 #include <rmw_microros/discovery.h>
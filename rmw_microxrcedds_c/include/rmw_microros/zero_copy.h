@@ -0,0 +1,61 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ */
+
+#ifndef RMW_MICROROS__ZERO_COPY_H_
+#define RMW_MICROROS__ZERO_COPY_H_
+
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw_microxrcedds_c/config.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+/** \addtogroup rmw micro-ROS RMW API
+ *  @{
+ */
+
+/**
+ * \brief Sets a destination message for zero-copy reception on a subscription.
+ *        Setting the destination lends it to the session: while no other sample is pending,
+ *        the next incoming sample is deserialized straight from the XRCE input stream into it,
+ *        skipping the static input buffers. Taking into the same message hands it back with the
+ *        sample, and the session does not write it again until it is lent once more by calling
+ *        this function, or by a take into it that finds nothing to take.
+ *        Taking into a different message while a sample is held in the destination fails,
+ *        except for `rmw_take_sequence`, which then takes the queued samples and leaves the
+ *        one in the destination for a later take.
+ * \param[in] subscription subscription where zero-copy reception is being configured
+ * \param[in] ros_message message that will receive samples, NULL to disable zero-copy reception
+ * \return RMW_RET_OK If the destination has been set.
+ * \return RMW_RET_INVALID_ARGUMENT If the subscription is not valid.
+ * \return RMW_RET_ERROR If a sample is still held in the previous destination.
+ */
+rmw_ret_t rmw_uros_set_zero_copy_destination(
+  rmw_subscription_t * subscription,
+  void * ros_message);
+
+/** @}*/
+
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
+#endif  // RMW_MICROROS__ZERO_COPY_H_
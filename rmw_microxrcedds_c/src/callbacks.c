@@ -14,8 +14,42 @@
 
 #include <callbacks.h>
 
+#include <string.h>
+
 #include <rmw/error_handling.h>
 
+static void * find_entity_in_memory(
+  rmw_uxrce_mempool_t * memory,
+  size_t object_id_offset,
+  uxrObjectId object_id)
+{
+  // Fallback for entities that did not fit in the dispatch table
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(memory, &cursor);
+  while (item != NULL) {
+    uxrObjectId entity_id;
+    memcpy(&entity_id, (uint8_t *)item->data + object_id_offset, sizeof(uxrObjectId));
+    if ((entity_id.id == object_id.id) && (entity_id.type == object_id.type)) {
+      return item->data;
+    }
+    item = next_memory(memory, &cursor);
+  }
+  return NULL;
+}
+
+static void * find_entity(
+  rmw_uxrce_entity_table_t * table,
+  rmw_uxrce_mempool_t * memory,
+  size_t object_id_offset,
+  uxrObjectId object_id)
+{
+  void * entity = rmw_uxrce_entity_table_find(table, object_id);
+  if (NULL == entity && table->overflow > 0) {
+    entity = find_entity_in_memory(memory, object_id_offset, object_id);
+  }
+  return entity;
+}
+
 void on_status(
   struct uxrSession * session,
   uxrObjectId object_id,
@@ -24,10 +58,64 @@ void on_status(
   void * args)
 {
   (void)session;
-  (void)object_id;
-  (void)request_id;
-  (void)status;
-  (void)args;
+
+  rmw_context_impl_t * context = (rmw_context_impl_t *)args;
+
+  // Deferred requests are not awaited one by one, their status is kept for the commit
+  for (size_t i = 0; i < context->deferred_count; i++) {
+    if (context->deferred_requests[i] == request_id) {
+      context->deferred_status[i] = status;
+      context->deferred_objects[i] = object_id;
+      break;
+    }
+  }
+}
+
+static bool deserialize_into_destination(
+  struct uxrSession * session,
+  rmw_uxrce_subscription_t * custom_subscription,
+  struct ucdrBuffer * ub,
+  uint16_t length)
+{
+  // Readers without a destination do not take the lock for every sample
+  if (NULL == custom_subscription->zero_copy_destination) {
+    return false;
+  }
+
+  // Zero-copy is only used while the destination is lent and nothing older is queued.
+  // It is marked as being filled, so takes do not hand it back to the user meanwhile
+  UXR_LOCK(&static_buffer_memory.mutex);
+  bool use_destination = NULL != custom_subscription->zero_copy_destination &&
+    RMW_UXRCE_ZERO_COPY_LENT == custom_subscription->zero_copy_state &&
+    !rmw_uxrce_input_queue_has_data(&custom_subscription->input_queue) &&
+    ucdr_buffer_remaining(ub) >= length;
+  if (use_destination) {
+    custom_subscription->zero_copy_state = RMW_UXRCE_ZERO_COPY_FILLING;
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  if (!use_destination) {
+    return false;
+  }
+
+  ucdrBuffer payload;
+  ucdr_init_buffer(&payload, ub->iterator, length);
+
+  // On failure the sample falls back to the input queue, so the error is reported by rmw_take
+  bool deserialized = custom_subscription->type_support_callbacks->cdr_deserialize(
+    &payload, custom_subscription->zero_copy_destination);
+
+  UXR_LOCK(&static_buffer_memory.mutex);
+  if (deserialized) {
+    custom_subscription->zero_copy_timestamp = uxr_epoch_nanos(session);
+    custom_subscription->zero_copy_state = RMW_UXRCE_ZERO_COPY_PENDING;
+    rmw_uxrce_input_queue_set_ready(&custom_subscription->input_queue, true);
+  } else {
+    custom_subscription->zero_copy_state = RMW_UXRCE_ZERO_COPY_LENT;
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return deserialized;
 }
 
 void on_topic(
@@ -39,12 +127,12 @@ void on_topic(
   uint16_t length,
   void * args)
 {
-  (void)session;
   (void)request_id;
   (void)stream_id;
 
-#ifdef RMW_UXRCE_GRAPH
   rmw_context_impl_t * context_impl = (rmw_context_impl_t *)(args);
+
+#ifdef RMW_UXRCE_GRAPH
   rmw_graph_info_t * graph_info = &context_impl->graph_info;
 
   if (object_id.id == graph_info->datareader_id.id &&
@@ -56,42 +144,52 @@ void on_topic(
     graph_info->has_changed = true;
     return;
   }
-#else
-  (void)args;
 #endif  // RMW_UXRCE_GRAPH
 
-  // Iterate along the allocated subscriptions
-  rmw_uxrce_mempool_item_t * subscription_item = subscription_memory.allocateditems;
-  while (subscription_item != NULL) {
-    rmw_uxrce_subscription_t * custom_subscription =
-      (rmw_uxrce_subscription_t *)subscription_item->data;
-
-    // Check if topic is related to the subscription
-    if ((custom_subscription->datareader_id.id == object_id.id) &&
-      (custom_subscription->datareader_id.type == object_id.type))
-    {
-      rmw_uxrce_mempool_item_t * memory_node = get_memory(&static_buffer_memory);
-      if (!memory_node) {
-        RMW_SET_ERROR_MSG("Not available static buffer memory node");
-        return;
-      }
-
-      rmw_uxrce_static_input_buffer_t * static_buffer =
-        (rmw_uxrce_static_input_buffer_t *)memory_node->data;
-      static_buffer->owner = (void *) custom_subscription;
-      static_buffer->length = length;
-
-      if (!ucdr_deserialize_array_uint8_t(
-          ub,
-          static_buffer->buffer,
-          length))
-      {
-        put_memory(&static_buffer_memory, memory_node);
-      }
+  rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)find_entity(
+    &context_impl->subscription_table, &subscription_memory,
+    offsetof(rmw_uxrce_subscription_t, datareader_id), object_id);
+  if (NULL == custom_subscription) {
+    return;
+  }
 
-      break;
-    }
-    subscription_item = subscription_item->next;
+  if (deserialize_into_destination(session, custom_subscription, ub, length)) {
+    return;
+  }
+
+  // KEEP_LAST readers keep their newest samples, and make room in the shared arena
+  // by evicting their own oldest ones instead of starving other readers
+  rmw_uxrce_input_queue_make_room(&custom_subscription->input_queue);
+
+  rmw_uxrce_static_input_buffer_t * static_buffer = NULL;
+  do {
+    static_buffer = (custom_subscription->loan_size > 0) ?
+      rmw_uxrce_get_loanable_static_input_buffer(length, custom_subscription->loan_size) :
+      rmw_uxrce_get_static_input_buffer(length);
+  } while (NULL == static_buffer &&
+    rmw_uxrce_input_queue_evict(&custom_subscription->input_queue));
+
+  if (!static_buffer) {
+    RMW_SET_ERROR_MSG("Not available static buffer memory");
+    return;
+  }
+
+  static_buffer->timestamp = uxr_epoch_nanos(session);
+
+  static_buffer->owner = (void *) custom_subscription;
+
+  if (!ucdr_deserialize_array_uint8_t(
+      ub,
+      static_buffer->buffer,
+      length))
+  {
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+    return;
+  }
+
+  if (!rmw_uxrce_input_queue_push(&custom_subscription->input_queue, static_buffer)) {
+    RMW_SET_ERROR_MSG("Input queue full");
+    rmw_uxrce_put_static_input_buffer(static_buffer);
   }
 }
 
@@ -104,39 +202,40 @@ void on_request(
   uint16_t length,
   void * args)
 {
-  (void)session;
-  (void)object_id;
-  (void)args;
-
-  // Iterate along the allocated services
-  rmw_uxrce_mempool_item_t * service_item = service_memory.allocateditems;
-  while (service_item != NULL) {
-    // Check if request is related to the service
-    rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)service_item->data;
-    if (custom_service->service_data_resquest == request_id) {
-      rmw_uxrce_mempool_item_t * memory_node = get_memory(&static_buffer_memory);
-      if (!memory_node) {
-        RMW_SET_ERROR_MSG("Not available static buffer memory node");
-        return;
-      }
-
-      rmw_uxrce_static_input_buffer_t * static_buffer =
-        (rmw_uxrce_static_input_buffer_t *)memory_node->data;
-      static_buffer->owner = (void *) custom_service;
-      static_buffer->length = length;
-      static_buffer->related.sample_id = *sample_id;
-
-      if (!ucdr_deserialize_array_uint8_t(
-          ub,
-          static_buffer->buffer,
-          length))
-      {
-        put_memory(&static_buffer_memory, memory_node);
-      }
+  (void)request_id;
 
-      break;
-    }
-    service_item = service_item->next;
+  rmw_context_impl_t * context_impl = (rmw_context_impl_t *)(args);
+
+  rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)find_entity(
+    &context_impl->service_table, &service_memory,
+    offsetof(rmw_uxrce_service_t, service_id), object_id);
+  if (NULL == custom_service) {
+    return;
+  }
+
+  rmw_uxrce_static_input_buffer_t * static_buffer = rmw_uxrce_get_static_input_buffer(length);
+  if (!static_buffer) {
+    RMW_SET_ERROR_MSG("Not available static buffer memory");
+    return;
+  }
+
+  static_buffer->timestamp = uxr_epoch_nanos(session);
+
+  static_buffer->owner = (void *) custom_service;
+  static_buffer->related.sample_id = *sample_id;
+
+  if (!ucdr_deserialize_array_uint8_t(
+      ub,
+      static_buffer->buffer,
+      length))
+  {
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+    return;
+  }
+
+  if (!rmw_uxrce_input_queue_push(&custom_service->input_queue, static_buffer)) {
+    RMW_SET_ERROR_MSG("Input queue full");
+    rmw_uxrce_put_static_input_buffer(static_buffer);
   }
 }
 
@@ -149,38 +248,39 @@ void on_reply(
   uint16_t length,
   void * args)
 {
-  (void)session;
-  (void)object_id;
-  (void)args;
-
-  // Iterate along the allocated clients
-  rmw_uxrce_mempool_item_t * client_item = client_memory.allocateditems;
-  while (client_item != NULL) {
-    // Check if reply is related to the client
-    rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)client_item->data;
-    if (custom_client->client_data_request == request_id) {
-      rmw_uxrce_mempool_item_t * memory_node = get_memory(&static_buffer_memory);
-      if (!memory_node) {
-        RMW_SET_ERROR_MSG("Not available static buffer memory node");
-        return;
-      }
-
-      rmw_uxrce_static_input_buffer_t * static_buffer =
-        (rmw_uxrce_static_input_buffer_t *)memory_node->data;
-      static_buffer->owner = (void *) custom_client;
-      static_buffer->length = length;
-      static_buffer->related.reply_id = reply_id;
-
-      if (!ucdr_deserialize_array_uint8_t(
-          ub,
-          static_buffer->buffer,
-          length))
-      {
-        put_memory(&static_buffer_memory, memory_node);
-      }
+  (void)request_id;
 
-      break;
-    }
-    client_item = client_item->next;
+  rmw_context_impl_t * context_impl = (rmw_context_impl_t *)(args);
+
+  rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)find_entity(
+    &context_impl->client_table, &client_memory,
+    offsetof(rmw_uxrce_client_t, client_id), object_id);
+  if (NULL == custom_client) {
+    return;
+  }
+
+  rmw_uxrce_static_input_buffer_t * static_buffer = rmw_uxrce_get_static_input_buffer(length);
+  if (!static_buffer) {
+    RMW_SET_ERROR_MSG("Not available static buffer memory");
+    return;
+  }
+
+  static_buffer->timestamp = uxr_epoch_nanos(session);
+
+  static_buffer->owner = (void *) custom_client;
+  static_buffer->related.reply_id = reply_id;
+
+  if (!ucdr_deserialize_array_uint8_t(
+      ub,
+      static_buffer->buffer,
+      length))
+  {
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+    return;
+  }
+
+  if (!rmw_uxrce_input_queue_push(&custom_client->input_queue, static_buffer)) {
+    RMW_SET_ERROR_MSG("Input queue full");
+    rmw_uxrce_put_static_input_buffer(static_buffer);
   }
 }
@@ -21,11 +21,178 @@
 
 #include <uxr/client/profile/multithread/multithread.h>
 
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+// Single producer (session) allocates and merges blocks, single consumer (take) frees them.
+// The only shared state is the in_use flag of each block and the used counter.
+#define ARENA_LOCK(arena)
+#define ARENA_UNLOCK(arena)
+#define ARENA_BLOCK_IN_USE(block) __atomic_load_n(&(block)->in_use, __ATOMIC_ACQUIRE)
+#define ARENA_BLOCK_SET_IN_USE(block, value) \
+  __atomic_store_n(&(block)->in_use, (value), __ATOMIC_RELEASE)
+#define ARENA_ADD_USED(arena, units) __atomic_fetch_add(&(arena)->used, (units), __ATOMIC_RELAXED)
+#define ARENA_SUB_USED(arena, units) __atomic_fetch_sub(&(arena)->used, (units), __ATOMIC_RELAXED)
+#else
+#define ARENA_LOCK(arena) UXR_LOCK(&(arena)->mutex)
+#define ARENA_UNLOCK(arena) UXR_UNLOCK(&(arena)->mutex)
+#define ARENA_BLOCK_IN_USE(block) ((block)->in_use)
+#define ARENA_BLOCK_SET_IN_USE(block, value) ((block)->in_use = (value))
+#define ARENA_ADD_USED(arena, units) ((arena)->used += (units))
+#define ARENA_SUB_USED(arena, units) ((arena)->used -= (units))
+#endif /* ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS */
+
+static rmw_uxrce_mempool_item_t * item_at(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_segment_t * segment,
+  size_t index)
+{
+  return (rmw_uxrce_mempool_item_t *)
+         (segment->elements + index * mem->element_size + mem->item_offset);
+}
+
+static rmw_uxrce_mempool_segment_t * find_segment(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_item_t * item,
+  size_t * index)
+{
+  uint8_t * element = (uint8_t *)item - mem->item_offset;
+  for (rmw_uxrce_mempool_segment_t * segment = &mem->segment; segment != NULL;
+    segment = segment->next)
+  {
+    if (element >= segment->elements &&
+      element < segment->elements + segment->size * mem->element_size)
+    {
+      *index = (size_t)(element - segment->elements) / mem->element_size;
+      return segment;
+    }
+  }
+  return NULL;
+}
+
+static void init_segment(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_segment_t * segment,
+  uint8_t * elements,
+  uint32_t * occupancy,
+  size_t size)
+{
+  segment->next = NULL;
+  segment->elements = elements;
+  segment->occupancy = occupancy;
+  segment->size = (uint16_t)size;
+  segment->used = 0;
+  segment->free_head = (size > 0) ? 0 : RMW_UXRCE_MEMPOOL_INVALID_INDEX;
+  segment->is_dynamic_memory = false;
+
+  memset(occupancy, 0, RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(size) * sizeof(uint32_t));
+  for (size_t i = 0; i < size; i++) {
+    rmw_uxrce_mempool_item_t * item = item_at(mem, segment, i);
+    item->data = (void *)(elements + i * mem->element_size);
+    item->next_free = (i + 1 < size) ? (uint16_t)(i + 1) : RMW_UXRCE_MEMPOOL_INVALID_INDEX;
+  }
+}
+
+#ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
+static rmw_uxrce_mempool_segment_t * allocate_segment(
+  rmw_uxrce_mempool_t * mem,
+  size_t size)
+{
+  // Header, bitmap and elements share a single allocation
+  const size_t header_size =
+    RMW_UXRCE_ARENA_UNITS(sizeof(rmw_uxrce_mempool_segment_t)) * sizeof(rmw_uxrce_arena_unit_t);
+  const size_t occupancy_size =
+    RMW_UXRCE_ARENA_UNITS(RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(size) * sizeof(uint32_t)) *
+    sizeof(rmw_uxrce_arena_unit_t);
+  const size_t total_size = header_size + occupancy_size + size * mem->element_size;
+
+  uint8_t * buffer = (uint8_t *)rmw_allocate(total_size);
+  if (buffer == NULL) {
+    return NULL;
+  }
+  memset(buffer, 0, total_size);
+
+  rmw_uxrce_mempool_segment_t * segment = (rmw_uxrce_mempool_segment_t *)buffer;
+  init_segment(
+    mem, segment, buffer + header_size + occupancy_size,
+    (uint32_t *)(buffer + header_size), size);
+  segment->is_dynamic_memory = true;
+  mem->capacity += size;
+  mem->dynamic_allocations++;
+
+  rmw_uxrce_mempool_segment_t * last = &mem->segment;
+  while (last->next != NULL) {
+    last = last->next;
+  }
+  last->next = segment;
+
+  return segment;
+}
+
+static void release_segment(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_segment_t * segment)
+{
+  // Empty chunks stay in the pool for reuse while few dynamic elements are free,
+  // so steady create/destroy churn does not hit the heap
+  size_t free_elements = 0;
+  for (rmw_uxrce_mempool_segment_t * it = mem->segment.next; it != NULL; it = it->next) {
+    if (it != segment) {
+      free_elements += it->size - it->used;
+    }
+  }
+  if (free_elements < RMW_UXRCE_DYNAMIC_POOL_MAX_FREE) {
+    return;
+  }
+
+  rmw_uxrce_mempool_segment_t * previous = &mem->segment;
+  while (previous->next != segment) {
+    previous = previous->next;
+  }
+  previous->next = segment->next;
+  mem->capacity -= segment->size;
+  mem->dynamic_frees++;
+  rmw_free(segment);
+}
+#endif /* ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS */
+
+void init_memory(
+  rmw_uxrce_mempool_t * mem,
+  void * elements,
+  size_t element_size,
+  size_t item_offset,
+  uint32_t * occupancy,
+  size_t size)
+{
+  // Empty pools are valid, they only grow dynamically if allowed
+  if (size < RMW_UXRCE_MEMPOOL_INVALID_INDEX && !mem->is_initialized) {
+    UXR_INIT_LOCK(&mem->mutex);
+    mem->is_initialized = true;
+    mem->element_size = element_size;
+    mem->item_offset = item_offset;
+    mem->is_dynamic_allowed = true;
+    mem->capacity = size;
+    mem->used = 0;
+    mem->high_water = 0;
+    mem->dynamic_allocations = 0;
+    mem->dynamic_frees = 0;
+    init_segment(mem, &mem->segment, (uint8_t *)elements, occupancy, size);
+  }
+}
+
 bool has_memory(
   rmw_uxrce_mempool_t * mem)
 {
+  bool rv = false;
+
+  if (!mem->is_initialized) {
+    return rv;
+  }
+
   UXR_LOCK(&mem->mutex);
-  bool rv = mem->freeitems != NULL ? true : false;
+  for (rmw_uxrce_mempool_segment_t * segment = &mem->segment; segment != NULL && !rv;
+    segment = segment->next)
+  {
+    rv = segment->free_head != RMW_UXRCE_MEMPOOL_INVALID_INDEX;
+  }
   UXR_UNLOCK(&mem->mutex);
 
   return rv;
@@ -34,37 +201,36 @@ bool has_memory(
 rmw_uxrce_mempool_item_t * get_memory(
   rmw_uxrce_mempool_t * mem)
 {
-  UXR_LOCK(&mem->mutex);
+  if (!mem->is_initialized) {
+    return NULL;
+  }
 
-  rmw_uxrce_mempool_item_t * item = NULL;
+  UXR_LOCK(&mem->mutex);
 
-  if (has_memory(mem)) {
-    // Gets item from free pool
-    item = mem->freeitems;
-    mem->freeitems = item->next;
-    if (mem->freeitems) {
-      mem->freeitems->prev = NULL;
-    }
+  rmw_uxrce_mempool_segment_t * segment = &mem->segment;
+  while (segment != NULL && segment->free_head == RMW_UXRCE_MEMPOOL_INVALID_INDEX) {
+    segment = segment->next;
+  }
 
-    // Puts item in allocated pool
-    item->next = mem->allocateditems;
-    if (item->next) {
-      item->next->prev = item;
-    }
-    item->prev = NULL;
-    mem->allocateditems = item;
-  } else if (mem->is_dynamic_allowed) {
 #ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
-    item = (rmw_uxrce_mempool_item_t *)rmw_allocate(sizeof(rmw_uxrce_mempool_item_t));
-    item->prev = NULL;
-    item->next = NULL;
-    item->data = (void *)rmw_allocate(mem->element_size);
-    memset(item->data, 0, mem->element_size);
-    item->is_dynamic_memory = false;     // Allow to put element in free pool the first time
-    put_memory(mem, item);
-    item->is_dynamic_memory = true;
-    item = get_memory(mem);
+  if (segment == NULL && mem->is_dynamic_allowed) {
+    segment = allocate_segment(mem, RMW_UXRCE_DYNAMIC_POOL_CHUNK);
+  }
 #endif /* ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS */
+
+  rmw_uxrce_mempool_item_t * item = NULL;
+
+  if (segment != NULL) {
+    // Pops the top of the free stack and flags it as allocated
+    size_t index = segment->free_head;
+    item = item_at(mem, segment, index);
+    segment->free_head = item->next_free;
+    segment->occupancy[index / 32] |= (uint32_t)1 << (index % 32);
+    segment->used++;
+    mem->used++;
+    if (mem->used > mem->high_water) {
+      mem->high_water = mem->used;
+    }
   }
 
   UXR_UNLOCK(&mem->mutex);
@@ -78,33 +244,159 @@ void put_memory(
 {
   UXR_LOCK(&mem->mutex);
 
-  // Gets item from allocated pool
-  if (item->prev) {
-    item->prev->next = item->next;
+  size_t index = 0;
+  rmw_uxrce_mempool_segment_t * segment = find_segment(mem, item, &index);
+
+  if (segment != NULL &&
+    (segment->occupancy[index / 32] & ((uint32_t)1 << (index % 32))))
+  {
+    segment->occupancy[index / 32] &= ~((uint32_t)1 << (index % 32));
+    segment->used--;
+    mem->used--;
+    item->next_free = segment->free_head;
+    segment->free_head = (uint16_t)index;
+
+#ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
+    if (segment->is_dynamic_memory && segment->used == 0) {
+      release_segment(mem, segment);
+    }
+#endif /* ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS */
   }
-  if (item->next) {
-    item->next->prev = item->prev;
+
+  UXR_UNLOCK(&mem->mutex);
+}
+
+bool seek_memory(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_cursor_t * cursor)
+{
+  // Walks start at the first segment and resume past the word just walked.
+  // Whole empty words are skipped, so sparse pools are walked without touching their elements
+  rmw_uxrce_mempool_segment_t * segment = cursor->segment;
+  size_t word_index = 0;
+  if (segment == NULL) {
+    segment = mem->is_initialized ? &mem->segment : NULL;
+  } else {
+    word_index = (size_t)(cursor->occupancy - segment->occupancy) + 1;
   }
 
-  if (mem->allocateditems == item) {
-    mem->allocateditems = item->next;
+  for (; segment != NULL; segment = segment->next, word_index = 0) {
+    const size_t words = RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(segment->size);
+    for (; word_index < words; word_index++) {
+      if (segment->occupancy[word_index] != 0) {
+        cursor->segment = segment;
+        cursor->occupancy = &segment->occupancy[word_index];
+        cursor->items = (uint8_t *)item_at(mem, segment, word_index * 32);
+        cursor->word = segment->occupancy[word_index];
+        return true;
+      }
+    }
   }
 
-#ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
-  if (item->is_dynamic_memory) {
-    rmw_free(item->data);
-    rmw_free(item);
-    return;
+  cursor->segment = NULL;
+  cursor->word = 0;
+  return false;
+}
+
+void init_arena_memory(
+  rmw_uxrce_arena_t * arena,
+  rmw_uxrce_arena_unit_t * units,
+  size_t size)
+{
+  if (size > 0 && !arena->is_initialized) {
+    UXR_INIT_LOCK(&arena->mutex);
+    arena->is_initialized = true;
+    arena->units = units;
+    arena->size = size;
+    arena->rover = 0;
+    arena->used = 0;
+
+    // The whole arena starts as a single free block
+    rmw_uxrce_arena_block_t * block = (rmw_uxrce_arena_block_t *)&units[0];
+    block->units = (uint32_t)size;
+    block->in_use = 0;
   }
-#endif /* ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS */
+}
 
-  // Puts item in free pool
-  item->next = mem->freeitems;
-  if (item->next) {
-    item->next->prev = item;
+void * get_arena_memory(
+  rmw_uxrce_arena_t * arena,
+  size_t size)
+{
+  const size_t header_units = RMW_UXRCE_ARENA_UNITS(sizeof(rmw_uxrce_arena_block_t));
+  const size_t needed = RMW_UXRCE_ARENA_BLOCK_UNITS(size);
+  void * data = NULL;
+
+  if (needed > arena->size) {
+    return NULL;
   }
-  item->prev = NULL;
-  mem->freeitems = item;
 
-  UXR_UNLOCK(&mem->mutex);
+  ARENA_LOCK(arena);
+
+  // Next-fit search: allocations move around the arena like a ring,
+  // adjacent free blocks are merged while walking over them
+  size_t index = arena->rover;
+  size_t scanned = 0;
+  while (scanned < arena->size) {
+    if (index >= arena->size) {
+      index = 0;
+    }
+
+    rmw_uxrce_arena_block_t * block = (rmw_uxrce_arena_block_t *)&arena->units[index];
+    if (!ARENA_BLOCK_IN_USE(block)) {
+      size_t next = index + block->units;
+      while (next < arena->size) {
+        rmw_uxrce_arena_block_t * next_block = (rmw_uxrce_arena_block_t *)&arena->units[next];
+        if (ARENA_BLOCK_IN_USE(next_block)) {
+          break;
+        }
+        block->units += next_block->units;
+        next += next_block->units;
+      }
+      if (arena->rover > index && arena->rover < next) {
+        arena->rover = index;
+      }
+
+      if (block->units >= needed) {
+        size_t remaining = block->units - needed;
+        if (remaining > header_units) {
+          rmw_uxrce_arena_block_t * split =
+            (rmw_uxrce_arena_block_t *)&arena->units[index + needed];
+          split->units = (uint32_t)remaining;
+          split->in_use = 0;
+          block->units = (uint32_t)needed;
+        }
+        ARENA_BLOCK_SET_IN_USE(block, 1);
+        ARENA_ADD_USED(arena, block->units);
+        arena->rover = index + block->units;
+        data = (void *)&arena->units[index + header_units];
+        break;
+      }
+    }
+
+    scanned += block->units;
+    index += block->units;
+  }
+
+  ARENA_UNLOCK(arena);
+
+  return data;
+}
+
+void put_arena_memory(
+  rmw_uxrce_arena_t * arena,
+  void * data)
+{
+  const size_t header_units = RMW_UXRCE_ARENA_UNITS(sizeof(rmw_uxrce_arena_block_t));
+
+  ARENA_LOCK(arena);
+
+  // Freeing only clears the flag, blocks are merged on the next allocations.
+  // The size is read before releasing the block, as the producer may merge it afterwards
+  rmw_uxrce_arena_block_t * block =
+    (rmw_uxrce_arena_block_t *)((rmw_uxrce_arena_unit_t *)data - header_units);
+  uint32_t units = block->units;
+  ARENA_SUB_USED(arena, units);
+  ARENA_BLOCK_SET_IN_USE(block, 0);
+
+  ARENA_UNLOCK(arena);
 }
@@ -17,23 +17,54 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include <uxr/client/profile/multithread/multithread.h>
 
+#define RMW_UXRCE_MEMPOOL_INVALID_INDEX UINT16_MAX
+#define RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(size) (((size) + 31) / 32)
+
+// Embedded in every pooled element
 typedef struct rmw_uxrce_mempool_item_t
 {
-  struct rmw_uxrce_mempool_item_t * prev;
-  struct rmw_uxrce_mempool_item_t * next;
   void * data;
-  bool is_dynamic_memory;
+  uint16_t next_free;
 } rmw_uxrce_mempool_item_t;
 
+// Contiguous run of elements: free items form a stack of 16-bit indices
+// and allocated ones are flagged in a bitmap, so they are walked in array order
+typedef struct rmw_uxrce_mempool_segment_t
+{
+  struct rmw_uxrce_mempool_segment_t * next;
+  uint8_t * elements;
+  uint32_t * occupancy;
+  uint16_t size;
+  uint16_t used;
+  uint16_t free_head;
+  bool is_dynamic_memory;
+} rmw_uxrce_mempool_segment_t;
+
+// Position of a walk over the allocated items of a pool: the occupancy word being walked,
+// the item its first bit stands for and the allocated items of the word not returned yet
+typedef struct rmw_uxrce_mempool_cursor_t
+{
+  rmw_uxrce_mempool_segment_t * segment;
+  uint32_t * occupancy;
+  uint8_t * items;
+  uint32_t word;
+} rmw_uxrce_mempool_cursor_t;
+
 typedef struct rmw_uxrce_mempool_t
 {
-  struct rmw_uxrce_mempool_item_t * allocateditems;
-  struct rmw_uxrce_mempool_item_t * freeitems;
+  rmw_uxrce_mempool_segment_t segment;
 
   size_t element_size;
+  size_t item_offset;
+  size_t capacity;
+  size_t used;
+  size_t high_water;
+  size_t dynamic_allocations;
+  size_t dynamic_frees;
   bool is_initialized;
   bool is_dynamic_allowed;
 
@@ -42,6 +73,48 @@ typedef struct rmw_uxrce_mempool_t
 #endif  // UCLIENT_PROFILE_MULTITHREAD
 } rmw_uxrce_mempool_t;
 
+// Contiguous arena of variable-size blocks
+
+typedef union rmw_uxrce_arena_unit_t
+{
+  uint64_t u64;
+  double f64;
+  void * ptr;
+} rmw_uxrce_arena_unit_t;
+
+typedef struct rmw_uxrce_arena_block_t
+{
+  uint32_t units;
+  uint32_t in_use;
+} rmw_uxrce_arena_block_t;
+
+typedef struct rmw_uxrce_arena_t
+{
+  rmw_uxrce_arena_unit_t * units;
+  size_t size;
+  size_t rover;
+  size_t used;
+
+  bool is_initialized;
+
+#ifdef UCLIENT_PROFILE_MULTITHREAD
+  uxrMutex mutex;
+#endif  // UCLIENT_PROFILE_MULTITHREAD
+} rmw_uxrce_arena_t;
+
+#define RMW_UXRCE_ARENA_UNITS(bytes) \
+  (((bytes) + sizeof(rmw_uxrce_arena_unit_t) - 1) / sizeof(rmw_uxrce_arena_unit_t))
+
+#define RMW_UXRCE_ARENA_BLOCK_UNITS(bytes) \
+  (RMW_UXRCE_ARENA_UNITS(sizeof(rmw_uxrce_arena_block_t)) + RMW_UXRCE_ARENA_UNITS(bytes))
+
+void init_memory(
+  rmw_uxrce_mempool_t * mem,
+  void * elements,
+  size_t element_size,
+  size_t item_offset,
+  uint32_t * occupancy,
+  size_t size);
 bool has_memory(
   rmw_uxrce_mempool_t * mem);
 rmw_uxrce_mempool_item_t * get_memory(
@@ -49,5 +122,64 @@ rmw_uxrce_mempool_item_t * get_memory(
 void put_memory(
   rmw_uxrce_mempool_t * mem,
   rmw_uxrce_mempool_item_t * item);
+bool seek_memory(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_cursor_t * cursor);
+
+static inline size_t rmw_uxrce_mempool_lowest_bit(
+  uint32_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctz(word);
+#else
+  size_t bit = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif /* if defined(__GNUC__) || defined(__clang__) */
+}
+
+// Walks stay in the current occupancy word without calling into the pool,
+// items released since the word was loaded are skipped
+static inline rmw_uxrce_mempool_item_t * next_memory(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_cursor_t * cursor)
+{
+  uint32_t word = cursor->word;
+  if (word != 0) {
+    word &= *cursor->occupancy;
+  }
+  if (word == 0) {
+    if (!seek_memory(mem, cursor)) {
+      return NULL;
+    }
+    word = cursor->word;
+  }
+  cursor->word = word & (word - 1);
+  return (rmw_uxrce_mempool_item_t *)
+         (cursor->items + rmw_uxrce_mempool_lowest_bit(word) * mem->element_size);
+}
+
+static inline rmw_uxrce_mempool_item_t * first_memory(
+  rmw_uxrce_mempool_t * mem,
+  rmw_uxrce_mempool_cursor_t * cursor)
+{
+  cursor->segment = NULL;
+  cursor->word = 0;
+  return next_memory(mem, cursor);
+}
+
+void init_arena_memory(
+  rmw_uxrce_arena_t * arena,
+  rmw_uxrce_arena_unit_t * units,
+  size_t size);
+void * get_arena_memory(
+  rmw_uxrce_arena_t * arena,
+  size_t size);
+void put_arena_memory(
+  rmw_uxrce_arena_t * arena,
+  void * data);
 
 #endif  // MEMORY_H_
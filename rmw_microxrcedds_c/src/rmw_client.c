@@ -69,6 +69,8 @@ rmw_create_client(
     rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)memory_node->data;
     custom_client->rmw_handle = rmw_client;
     custom_client->owner_node = custom_node;
+    rmw_uxrce_input_queue_init(&custom_client->input_queue);
+    custom_client->async_reliable = false;
 
     const rosidl_service_type_support_t * type_support_xrce = NULL;
 #ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE
@@ -94,8 +96,10 @@ rmw_create_client(
       goto fail;
     }
 
-    custom_client->client_id =
-      uxr_object_id(custom_node->context->id_requester++, UXR_REQUESTER_ID);
+    custom_client->client_id = rmw_uxrce_entity_table_next_id(
+      &custom_node->context->client_table,
+      &custom_node->context->id_requester,
+      UXR_REQUESTER_ID);
 
     uint16_t client_req = UXR_INVALID_REQUEST_ID;
 
@@ -122,9 +126,13 @@ rmw_create_client(
 #else
     char req_type_name[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
     char res_type_name[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
-    generate_service_types(
-      custom_client->type_support_callbacks, req_type_name, res_type_name,
-      RMW_UXRCE_TYPE_NAME_MAX_LENGTH);
+    if (!generate_service_types(
+        custom_client->type_support_callbacks, req_type_name, res_type_name,
+        RMW_UXRCE_TYPE_NAME_MAX_LENGTH))
+    {
+      RMW_SET_ERROR_MSG("failed to generate type names for client creation");
+      goto fail;
+    }
 
     char req_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH];
     char res_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH];
@@ -168,6 +176,10 @@ rmw_create_client(
       custom_node->context->best_effort_input :
       custom_node->context->reliable_input;
 
+    rmw_uxrce_entity_table_insert(
+      &custom_node->context->client_table,
+      custom_client->client_id, custom_client);
+
     custom_client->client_data_request = uxr_buffer_request_data(
       &custom_node->context->session,
       *custom_node->context->creation_destroy_stream, custom_client->client_id,
@@ -208,6 +220,11 @@ rmw_destroy_client(
   } else {
     rmw_uxrce_node_t * custom_node = (rmw_uxrce_node_t *)node->data;
     rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)client->data;
+
+    rmw_uxrce_entity_table_remove(
+      &custom_node->context->client_table,
+      custom_client->client_id, custom_client);
+
     uint16_t delete_client =
       uxr_buffer_delete_entity(
       &custom_node->context->session,
@@ -38,10 +38,11 @@ rmw_get_gid_for_publisher(
     return RMW_RET_ERROR;
   }
 
+  // Datawriters identify publishers, the XRCE publisher is shared by the node
   memset(gid->data, 0, RMW_GID_STORAGE_SIZE);
   memcpy(
     gid->data,
-    &custom_publisher->publisher_id,
+    &custom_publisher->datawriter_id,
     sizeof(uxrObjectId));
 
 
@@ -59,6 +59,8 @@ rmw_init_options_init(
   init_options->localhost_only = RMW_LOCALHOST_ONLY_DEFAULT;
 
   init_options->impl = allocator.allocate(sizeof(rmw_init_options_impl_t), allocator.state);
+  init_options->impl->memory_arena = NULL;
+  init_options->impl->memory_arena_size = 0;
 
 #if defined(RMW_UXRCE_TRANSPORT_SERIAL)
   if (strlen(RMW_UXRCE_DEFAULT_SERIAL_DEVICE) <= MAX_SERIAL_DEVICE) {
@@ -168,11 +170,38 @@ rmw_init(
   context->implementation_identifier = eprosima_microxrcedds_identifier;
   context->actual_domain_id = options->domain_id;
 
-  rmw_uxrce_init_session_memory(&session_memory, custom_sessions, RMW_UXRCE_MAX_SESSIONS);
-  rmw_uxrce_init_static_input_buffer_memory(
-    &static_buffer_memory, custom_static_buffers,
-    RMW_UXRCE_MAX_HISTORY);
-  static_buffer_memory.is_dynamic_allowed = false;
+  if (NULL != options->impl->memory_arena) {
+    rmw_uxrce_init_memory_arena(
+      options->impl->memory_arena, &options->impl->memory_arena_counts);
+  } else {
+#ifdef RMW_UXRCE_STATIC_MEMORY_POOLS
+    rmw_uxrce_init_session_memory(
+      &session_memory, custom_sessions, custom_sessions_occupancy, RMW_UXRCE_MAX_SESSIONS);
+    rmw_uxrce_init_static_input_buffer_memory(
+      &static_buffer_memory, custom_static_buffers,
+      RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS);
+    rmw_uxrce_init_node_memory(
+      &node_memory, custom_nodes, custom_nodes_occupancy, RMW_UXRCE_MAX_NODES);
+    rmw_uxrce_init_subscription_memory(
+      &subscription_memory, custom_subscriptions, custom_subscriptions_occupancy,
+      RMW_UXRCE_MAX_SUBSCRIPTIONS);
+    rmw_uxrce_init_publisher_memory(
+      &publisher_memory, custom_publishers, custom_publishers_occupancy,
+      RMW_UXRCE_MAX_PUBLISHERS);
+    rmw_uxrce_init_service_memory(
+      &service_memory, custom_services, custom_services_occupancy, RMW_UXRCE_MAX_SERVICES);
+    rmw_uxrce_init_client_memory(
+      &client_memory, custom_clients, custom_clients_occupancy, RMW_UXRCE_MAX_CLIENTS);
+    rmw_uxrce_init_topic_memory(
+      &topics_memory, custom_topics, custom_topics_occupancy, RMW_UXRCE_MAX_TOPICS_INTERNAL);
+#else
+    // Pools can only come from an arena given to a previous context
+    if (!session_memory.is_initialized) {
+      RMW_SET_ERROR_MSG("static memory pools disabled, a memory arena is required");
+      return RMW_RET_INVALID_ARGUMENT;
+    }
+#endif  // RMW_UXRCE_STATIC_MEMORY_POOLS
+  }
 
   rmw_uxrce_mempool_item_t * memory_node = get_memory(&session_memory);
   if (!memory_node) {
@@ -202,19 +231,32 @@ rmw_init(
   context_impl->id_requester = 0;
   context_impl->id_replier = 0;
 
+  rmw_uxrce_init_priority_classes(
+    context_impl->priority_classes, RMW_UXRCE_PRIORITY_CLASSES);
+
+  context_impl->publish_batch = false;
+  context_impl->publish_batch_reliable = false;
+
+  context_impl->deferred_entities = false;
+  context_impl->deferred_count = 0;
+  context_impl->deferred_unconfirmed = 0;
+
+  rmw_uxrce_init_entity_table(
+    &context_impl->subscription_table,
+    context_impl->subscription_table_entries, RMW_UXRCE_MAX_SUBSCRIPTIONS);
+  rmw_uxrce_init_entity_table(
+    &context_impl->service_table,
+    context_impl->service_table_entries, RMW_UXRCE_MAX_SERVICES);
+  rmw_uxrce_init_entity_table(
+    &context_impl->client_table,
+    context_impl->client_table_entries, RMW_UXRCE_MAX_CLIENTS);
+
   context_impl->graph_guard_condition.implementation_identifier = eprosima_microxrcedds_identifier;
   context_impl->graph_guard_condition.data = NULL;
 
   context->impl = context_impl;
 
-  rmw_uxrce_init_node_memory(&node_memory, custom_nodes, RMW_UXRCE_MAX_NODES);
-  rmw_uxrce_init_subscription_memory(
-    &subscription_memory, custom_subscriptions,
-    RMW_UXRCE_MAX_SUBSCRIPTIONS);
-  rmw_uxrce_init_publisher_memory(&publisher_memory, custom_publishers, RMW_UXRCE_MAX_PUBLISHERS);
-  rmw_uxrce_init_service_memory(&service_memory, custom_services, RMW_UXRCE_MAX_SERVICES);
-  rmw_uxrce_init_client_memory(&client_memory, custom_clients, RMW_UXRCE_MAX_CLIENTS);
-  rmw_uxrce_init_topic_memory(&topics_memory, custom_topics, RMW_UXRCE_MAX_TOPICS_INTERNAL);
+  rmw_uxrce_init_type_name_table(&type_name_table);
 
   // Micro-XRCE-DDS Client transport initialization
   rmw_ret_t transport_init_ret = rmw_uxrce_transport_init(
@@ -228,24 +270,34 @@ rmw_init(
     options->impl->transport_params.client_key);
 
   uxr_set_topic_callback(&context_impl->session, on_topic, (void *)(context_impl));
-  uxr_set_status_callback(&context_impl->session, on_status, NULL);
-  uxr_set_request_callback(&context_impl->session, on_request, NULL);
-  uxr_set_reply_callback(&context_impl->session, on_reply, NULL);
+  uxr_set_status_callback(&context_impl->session, on_status, (void *)(context_impl));
+  uxr_set_request_callback(&context_impl->session, on_request, (void *)(context_impl));
+  uxr_set_reply_callback(&context_impl->session, on_reply, (void *)(context_impl));
 
   context_impl->reliable_input = uxr_create_input_reliable_stream(
     &context_impl->session, context_impl->input_reliable_stream_buffer,
     context_impl->transport.comm.mtu * RMW_UXRCE_STREAM_HISTORY_INPUT,
     RMW_UXRCE_STREAM_HISTORY_INPUT);
-  context_impl->reliable_output =
-    uxr_create_output_reliable_stream(
-    &context_impl->session, context_impl->output_reliable_stream_buffer,
-    context_impl->transport.comm.mtu * RMW_UXRCE_STREAM_HISTORY_OUTPUT,
-    RMW_UXRCE_STREAM_HISTORY_OUTPUT);
+
+  // Output buffers are split evenly among the output streams
+  size_t reliable_output_size =
+    context_impl->transport.comm.mtu * RMW_UXRCE_STREAM_HISTORY_OUTPUT_PER_STREAM;
+  for (size_t i = 0; i < RMW_UXRCE_RELIABLE_OUTPUT_STREAMS; i++) {
+    context_impl->reliable_outputs[i] = uxr_create_output_reliable_stream(
+      &context_impl->session,
+      &context_impl->output_reliable_stream_buffer[i * reliable_output_size],
+      reliable_output_size, RMW_UXRCE_STREAM_HISTORY_OUTPUT_PER_STREAM);
+  }
+  context_impl->reliable_output = context_impl->reliable_outputs[0];
 
   context_impl->best_effort_input = uxr_create_input_best_effort_stream(&context_impl->session);
-  context_impl->best_effort_output = uxr_create_output_best_effort_stream(
-    &context_impl->session,
-    context_impl->output_best_effort_stream_buffer, context_impl->transport.comm.mtu);
+  for (size_t i = 0; i < RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS; i++) {
+    context_impl->best_effort_outputs[i] = uxr_create_output_best_effort_stream(
+      &context_impl->session,
+      &context_impl->output_best_effort_stream_buffer[i * context_impl->transport.comm.mtu],
+      context_impl->transport.comm.mtu);
+  }
+  context_impl->best_effort_output = context_impl->best_effort_outputs[0];
 
   context_impl->creation_destroy_stream = (RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT > 0) ?
     &context_impl->reliable_output :
@@ -295,11 +347,12 @@ rmw_context_fini(
   // TODO(pablogs9): Should we manage not closed XRCE sessions?
   rmw_ret_t ret = RMW_RET_OK;
 
-  rmw_uxrce_mempool_item_t * item = node_memory.allocateditems;
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(&node_memory, &cursor);
 
   while (item != NULL) {
     rmw_uxrce_node_t * custom_node = (rmw_uxrce_node_t *)item->data;
-    item = item->next;
+    item = next_memory(&node_memory, &cursor);
     if (custom_node->context == context->impl) {
       ret = rmw_destroy_node(custom_node->rmw_handle);
     }
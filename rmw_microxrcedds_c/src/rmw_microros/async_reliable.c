@@ -0,0 +1,120 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+#include "../utils.h"
+
+rmw_ret_t rmw_uros_set_publisher_async_reliable(
+  rmw_publisher_t * publisher,
+  bool enable)
+{
+  if (NULL == publisher || NULL == publisher->data) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
+
+  custom_publisher->async_reliable = enable;
+  if (!enable) {
+    custom_publisher->in_flight_samples = 0;
+    custom_publisher->in_flight_bytes = 0;
+  }
+
+  return RMW_RET_OK;
+}
+
+rmw_ret_t rmw_uros_set_client_async_reliable(
+  rmw_client_t * client,
+  bool enable)
+{
+  if (NULL == client || NULL == client->data) {
+    RMW_SET_ERROR_MSG("client is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(client->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("client handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  ((rmw_uxrce_client_t *)client->data)->async_reliable = enable;
+
+  return RMW_RET_OK;
+}
+
+rmw_ret_t rmw_uros_set_service_async_reliable(
+  rmw_service_t * service,
+  bool enable)
+{
+  if (NULL == service || NULL == service->data) {
+    RMW_SET_ERROR_MSG("service is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(service->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("service handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  ((rmw_uxrce_service_t *)service->data)->async_reliable = enable;
+
+  return RMW_RET_OK;
+}
+
+rmw_ret_t rmw_uros_get_publisher_in_flight(
+  const rmw_publisher_t * publisher,
+  size_t * in_flight_samples,
+  size_t * unacked_bytes)
+{
+  if (NULL == publisher || NULL == publisher->data) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (NULL == in_flight_samples || NULL == unacked_bytes) {
+    RMW_SET_ERROR_MSG("output is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
+
+  *in_flight_samples = 0;
+  *unacked_bytes = 0;
+
+  if (UXR_RELIABLE_STREAM != custom_publisher->stream_id.type) {
+    return RMW_RET_OK;
+  }
+
+  rmw_uxrce_publisher_purge_in_flight(custom_publisher);
+  *in_flight_samples = custom_publisher->in_flight_samples;
+  *unacked_bytes = custom_publisher->in_flight_bytes;
+
+  return RMW_RET_OK;
+}
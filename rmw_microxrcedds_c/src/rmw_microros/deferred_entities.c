@@ -0,0 +1,129 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+#include "../utils.h"
+
+static bool is_deferred_request_created(
+  uint8_t status)
+{
+  return UXR_STATUS_OK == status || UXR_STATUS_OK_MATCHED == status;
+}
+
+static void report_deferred_failure(
+  rmw_context_impl_t * context)
+{
+  for (size_t i = 0; i < context->deferred_count; i++) {
+    uint8_t status = context->deferred_status[i];
+    if (UXR_STATUS_NONE == status) {
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "deferred request %u timed out", (unsigned)context->deferred_requests[i]);
+      return;
+    } else if (!is_deferred_request_created(status)) {
+      uxrObjectId object_id = context->deferred_objects[i];
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "deferred entity 0x%04X of type 0x%02X not created, status 0x%02X",
+        (unsigned)object_id.id, (unsigned)object_id.type, (unsigned)status);
+      return;
+    }
+  }
+}
+
+static void delete_deferred_entities(
+  rmw_context_impl_t * context)
+{
+  // Children go before their parents, so entities are deleted in reverse creation order
+  uint16_t requests[RMW_UXRCE_MAX_PIPELINED_REQUESTS];
+  size_t count = 0;
+  for (size_t i = context->deferred_count; i > 0; i--) {
+    if (!is_deferred_request_created(context->deferred_status[i - 1])) {
+      continue;
+    }
+    requests[count++] = uxr_buffer_delete_entity(
+      &context->session, *context->creation_destroy_stream, context->deferred_objects[i - 1]);
+    if (RMW_UXRCE_MAX_PIPELINED_REQUESTS == count) {
+      run_xrce_session_all(context, requests, count);
+      count = 0;
+    }
+  }
+  run_xrce_session_all(context, requests, count);
+}
+
+rmw_ret_t rmw_uros_defer_entities(
+  rmw_context_t * context)
+{
+  if (NULL == context || NULL == context->impl) {
+    RMW_SET_ERROR_MSG("context is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(context->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("context not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (context->impl->deferred_entities) {
+    RMW_SET_ERROR_MSG("entity creation already deferred");
+    return RMW_RET_ERROR;
+  }
+
+  context->impl->deferred_entities = true;
+  context->impl->deferred_count = 0;
+  context->impl->deferred_unconfirmed = 0;
+
+  return RMW_RET_OK;
+}
+
+rmw_ret_t rmw_uros_commit_entities(
+  rmw_context_t * context)
+{
+  if (NULL == context || NULL == context->impl) {
+    RMW_SET_ERROR_MSG("context is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(context->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("context not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_context_impl_t * context_impl = context->impl;
+
+  if (!context_impl->deferred_entities) {
+    RMW_SET_ERROR_MSG("entity creation not deferred");
+    return RMW_RET_ERROR;
+  }
+
+  context_impl->deferred_entities = false;
+
+  if (UXR_BEST_EFFORT_STREAM == context_impl->creation_destroy_stream->type) {
+    uxr_flash_output_streams(&context_impl->session);
+    return RMW_RET_OK;
+  }
+
+  if (!run_xrce_session_until_deferred_status(context_impl)) {
+    // Errors of the deletions are superseded by the one naming the failing entity
+    delete_deferred_entities(context_impl);
+    rmw_reset_error();
+    report_deferred_failure(context_impl);
+    return RMW_RET_ERROR;
+  }
+
+  return RMW_RET_OK;
+}
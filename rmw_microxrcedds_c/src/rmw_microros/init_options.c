@@ -132,3 +132,47 @@ rmw_ret_t rmw_uros_options_set_client_key(
 
   return RMW_RET_OK;
 }
+
+size_t rmw_uros_memory_arena_size(
+  const rmw_uros_memory_arena_counts_t * counts)
+{
+  return (NULL != counts) ? rmw_uxrce_memory_arena_size(counts) : 0;
+}
+
+rmw_ret_t rmw_uros_init_options_set_memory_arena(
+  void * buffer,
+  size_t size,
+  const rmw_uros_memory_arena_counts_t * counts,
+  rmw_init_options_t * rmw_options)
+{
+  if (NULL == rmw_options) {
+    RMW_SET_ERROR_MSG("Uninitialised rmw_init_options.");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (NULL == buffer || NULL == counts) {
+    RMW_SET_ERROR_MSG("memory arena is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (0 != (uintptr_t)buffer % sizeof(rmw_uxrce_arena_unit_t)) {
+    RMW_SET_ERROR_MSG("memory arena is misaligned");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (0 == counts->sessions || 0 == counts->history) {
+    RMW_SET_ERROR_MSG("memory arena needs at least one session and one history sample");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (size < rmw_uxrce_memory_arena_size(counts)) {
+    RMW_SET_ERROR_MSG("memory arena too small");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_options->impl->memory_arena = buffer;
+  rmw_options->impl->memory_arena_size = size;
+  rmw_options->impl->memory_arena_counts = *counts;
+
+  return RMW_RET_OK;
+}
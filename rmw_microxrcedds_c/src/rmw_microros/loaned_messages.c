@@ -0,0 +1,92 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+#include "../utils.h"
+
+rmw_ret_t rmw_uros_set_publisher_loan_pool(
+  rmw_publisher_t * publisher,
+  void * messages,
+  size_t message_size,
+  size_t count)
+{
+  if (NULL == publisher || NULL == publisher->data) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (NULL != messages &&
+    (0 == message_size || 0 == count || count > RMW_UXRCE_MAX_PUBLISHER_LOANS))
+  {
+    RMW_SET_ERROR_MSG("invalid loan pool size");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
+
+  if (0 != custom_publisher->loans_in_use) {
+    RMW_SET_ERROR_MSG("messages of the current loan pool are still lent");
+    return RMW_RET_ERROR;
+  }
+
+  custom_publisher->loan_pool = (uint8_t *)messages;
+  custom_publisher->loan_size = (NULL != messages) ? message_size : 0;
+  custom_publisher->loan_count = (NULL != messages) ? count : 0;
+  publisher->can_loan_messages = NULL != messages;
+
+  return RMW_RET_OK;
+}
+
+rmw_ret_t rmw_uros_set_subscription_loan_size(
+  rmw_subscription_t * subscription,
+  size_t message_size)
+{
+  if (NULL == subscription || NULL == subscription->data) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(subscription->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
+  rmw_ret_t ret = RMW_RET_OK;
+
+  // Queued samples were sized for the current loan size
+  UXR_LOCK(&static_buffer_memory.mutex);
+  if (NULL != custom_subscription->loans ||
+    rmw_uxrce_input_queue_has_data(&custom_subscription->input_queue))
+  {
+    RMW_SET_ERROR_MSG("samples are still lent or pending to be taken");
+    ret = RMW_RET_ERROR;
+  } else {
+    custom_subscription->loan_size = message_size;
+    subscription->can_loan_messages = message_size > 0;
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return ret;
+}
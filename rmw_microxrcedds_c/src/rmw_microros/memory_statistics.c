@@ -0,0 +1,74 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microros/memory_statistics.h>
+
+#include <string.h>
+
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+
+rmw_ret_t rmw_uros_get_memory_statistics(
+  rmw_uros_memory_pool_t pool,
+  rmw_uros_memory_statistics_t * statistics)
+{
+  if (NULL == statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_mempool_t * memory = NULL;
+  switch (pool) {
+    case RMW_UROS_MEMORY_POOL_SESSIONS:
+      memory = &session_memory;
+      break;
+    case RMW_UROS_MEMORY_POOL_NODES:
+      memory = &node_memory;
+      break;
+    case RMW_UROS_MEMORY_POOL_PUBLISHERS:
+      memory = &publisher_memory;
+      break;
+    case RMW_UROS_MEMORY_POOL_SUBSCRIPTIONS:
+      memory = &subscription_memory;
+      break;
+    case RMW_UROS_MEMORY_POOL_SERVICES:
+      memory = &service_memory;
+      break;
+    case RMW_UROS_MEMORY_POOL_CLIENTS:
+      memory = &client_memory;
+      break;
+    case RMW_UROS_MEMORY_POOL_TOPICS:
+      memory = &topics_memory;
+      break;
+    default:
+      RMW_SET_ERROR_MSG("unknown memory pool");
+      return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!memory->is_initialized) {
+    memset(statistics, 0, sizeof(rmw_uros_memory_statistics_t));
+    return RMW_RET_OK;
+  }
+
+  UXR_LOCK(&memory->mutex);
+  statistics->capacity = memory->capacity;
+  statistics->used = memory->used;
+  statistics->high_water = memory->high_water;
+  statistics->dynamic_allocations = memory->dynamic_allocations;
+  statistics->dynamic_frees = memory->dynamic_frees;
+  UXR_UNLOCK(&memory->mutex);
+
+  return RMW_RET_OK;
+}
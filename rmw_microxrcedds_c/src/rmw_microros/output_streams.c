@@ -0,0 +1,64 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+#include "../utils.h"
+
+rmw_ret_t rmw_uros_set_publisher_output_stream(
+  rmw_publisher_t * publisher,
+  size_t index)
+{
+  if (NULL == publisher || NULL == publisher->data) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
+  rmw_context_impl_t * context = custom_publisher->owner_node->context;
+
+  if (UXR_BEST_EFFORT_STREAM == custom_publisher->stream_id.type) {
+    if (index >= RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS) {
+      RMW_SET_ERROR_MSG("best effort output stream index out of range");
+      return RMW_RET_INVALID_ARGUMENT;
+    }
+    custom_publisher->stream_id = context->best_effort_outputs[index];
+    return RMW_RET_OK;
+  }
+
+  if (index >= RMW_UXRCE_RELIABLE_OUTPUT_STREAMS) {
+    RMW_SET_ERROR_MSG("reliable output stream index out of range");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  // In-flight samples must be acknowledged before leaving the current stream
+  rmw_uxrce_publisher_purge_in_flight(custom_publisher);
+  if (custom_publisher->in_flight_samples > 0) {
+    RMW_SET_ERROR_MSG("publisher has samples waiting for acknowledgement");
+    return RMW_RET_ERROR;
+  }
+
+  custom_publisher->stream_id = context->reliable_outputs[index];
+
+  return RMW_RET_OK;
+}
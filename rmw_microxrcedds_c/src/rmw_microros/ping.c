@@ -32,8 +32,10 @@ rmw_ret_t rmw_uros_ping_agent(
   const uint8_t attempts)
 {
   bool success = false;
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(&session_memory, &cursor);
 
-  if (NULL == session_memory.allocateditems) {
+  if (NULL == item) {
 #ifdef RMW_UXRCE_TRANSPORT_SERIAL
     uxrSerialTransport transport;
 #elif defined(RMW_UXRCE_TRANSPORT_UDP)
@@ -56,12 +58,11 @@ rmw_ret_t rmw_uros_ping_agent(
     success = uxr_ping_agent_attempts(&transport.comm, timeout_ms, attempts);
     CLOSE_TRANSPORT(&transport);
   } else {
-    rmw_uxrce_mempool_item_t * item = session_memory.allocateditems;
     do {
       rmw_context_impl_t * context = (rmw_context_impl_t *)item->data;
 
       success = uxr_ping_agent_attempts(&context->transport.comm, timeout_ms, attempts);
-      item = item->next;
+      item = next_memory(&session_memory, &cursor);
     } while (NULL != item && !success);
   }
 
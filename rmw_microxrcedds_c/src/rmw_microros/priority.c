@@ -0,0 +1,120 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw_microros/output_streams.h>
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+#include "../utils.h"
+
+rmw_ret_t rmw_uros_set_publisher_priority(
+  rmw_publisher_t * publisher,
+  size_t priority)
+{
+  if (NULL == publisher || NULL == publisher->data) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (priority >= RMW_UXRCE_PRIORITY_CLASSES) {
+    RMW_SET_ERROR_MSG("priority class out of range");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
+
+  // Classes beyond the available streams share the last one
+  size_t streams = (UXR_BEST_EFFORT_STREAM == custom_publisher->stream_id.type) ?
+    RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS : RMW_UXRCE_RELIABLE_OUTPUT_STREAMS;
+  size_t index = (priority < streams) ? priority : streams - 1;
+
+  rmw_ret_t ret = rmw_uros_set_publisher_output_stream(publisher, index);
+  if (RMW_RET_OK == ret) {
+    custom_publisher->priority = priority;
+  }
+
+  return ret;
+}
+
+rmw_ret_t rmw_uros_set_priority_budget(
+  rmw_context_t * context,
+  size_t priority,
+  size_t bytes_per_second)
+{
+  if (NULL == context || NULL == context->impl) {
+    RMW_SET_ERROR_MSG("context is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(context->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("context not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (priority >= RMW_UXRCE_PRIORITY_CLASSES) {
+    RMW_SET_ERROR_MSG("priority class out of range");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_priority_class_t * priority_class = &context->impl->priority_classes[priority];
+
+  rmw_uxrce_init_priority_classes(priority_class, 1);
+  priority_class->budget = bytes_per_second;
+
+  // Starts with a full bucket, it is clamped to the burst size on first use
+  priority_class->tokens = (int64_t)bytes_per_second;
+
+  return RMW_RET_OK;
+}
+
+rmw_ret_t rmw_uros_get_priority_usage(
+  rmw_context_t * context,
+  size_t priority,
+  size_t * sent_bytes,
+  size_t * dropped_samples)
+{
+  if (NULL == context || NULL == context->impl) {
+    RMW_SET_ERROR_MSG("context is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(context->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("context not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (priority >= RMW_UXRCE_PRIORITY_CLASSES) {
+    RMW_SET_ERROR_MSG("priority class out of range");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_priority_class_t * priority_class = &context->impl->priority_classes[priority];
+
+  if (NULL != sent_bytes) {
+    *sent_bytes = priority_class->sent_bytes;
+  }
+  if (NULL != dropped_samples) {
+    *dropped_samples = priority_class->dropped_samples;
+  }
+
+  return RMW_RET_OK;
+}
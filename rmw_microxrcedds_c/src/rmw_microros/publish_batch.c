@@ -0,0 +1,80 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+#include "../utils.h"
+
+rmw_ret_t rmw_uros_begin_publish_batch(
+  rmw_context_t * context)
+{
+  if (NULL == context || NULL == context->impl) {
+    RMW_SET_ERROR_MSG("context is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(context->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("context not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (context->impl->publish_batch) {
+    RMW_SET_ERROR_MSG("publish batch already open");
+    return RMW_RET_ERROR;
+  }
+
+  context->impl->publish_batch = true;
+  context->impl->publish_batch_reliable = false;
+
+  return RMW_RET_OK;
+}
+
+rmw_ret_t rmw_uros_end_publish_batch(
+  rmw_context_t * context)
+{
+  if (NULL == context || NULL == context->impl) {
+    RMW_SET_ERROR_MSG("context is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(context->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("context not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_context_impl_t * context_impl = context->impl;
+
+  if (!context_impl->publish_batch) {
+    RMW_SET_ERROR_MSG("no publish batch open");
+    return RMW_RET_ERROR;
+  }
+
+  context_impl->publish_batch = false;
+
+  uxr_flash_output_streams(&context_impl->session);
+
+  if (context_impl->publish_batch_reliable &&
+    !uxr_run_session_until_confirm_delivery(
+      &context_impl->session, RMW_UXRCE_PUBLISH_RELIABLE_TIMEOUT))
+  {
+    RMW_SET_ERROR_MSG("publish batch delivery not confirmed");
+    return RMW_RET_ERROR;
+  }
+
+  return RMW_RET_OK;
+}
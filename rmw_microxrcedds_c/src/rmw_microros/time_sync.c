@@ -22,12 +22,14 @@
 
 bool rmw_uros_epoch_synchronized()
 {
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(&session_memory, &cursor);
+
   // Check session is initialized
-  if (NULL == session_memory.allocateditems) {
+  if (NULL == item) {
     RMW_SET_ERROR_MSG("Uninitialized session.");
     return false;
   }
-  rmw_uxrce_mempool_item_t * item = session_memory.allocateditems;
   rmw_context_impl_t * context = (rmw_context_impl_t *)item->data;
 
   return context->session.synchronized;
@@ -35,13 +37,14 @@ bool rmw_uros_epoch_synchronized()
 
 int64_t rmw_uros_epoch_millis()
 {
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(&session_memory, &cursor);
+
   // Check session is initialized
-  if (NULL == session_memory.allocateditems) {
+  if (NULL == item) {
     RMW_SET_ERROR_MSG("Uninitialized session.");
     return 0;
   }
-
-  rmw_uxrce_mempool_item_t * item = session_memory.allocateditems;
   rmw_context_impl_t * context = (rmw_context_impl_t *)item->data;
 
   return uxr_epoch_millis(&context->session);
@@ -49,13 +52,14 @@ int64_t rmw_uros_epoch_millis()
 
 int64_t rmw_uros_epoch_nanos()
 {
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(&session_memory, &cursor);
+
   // Check session is initialized
-  if (NULL == session_memory.allocateditems) {
+  if (NULL == item) {
     RMW_SET_ERROR_MSG("Uninitialized session.");
     return 0;
   }
-
-  rmw_uxrce_mempool_item_t * item = session_memory.allocateditems;
   rmw_context_impl_t * context = (rmw_context_impl_t *)item->data;
 
   return uxr_epoch_nanos(&context->session);
@@ -66,13 +70,14 @@ rmw_ret_t rmw_uros_sync_session(
 {
   rmw_ret_t ret = RMW_RET_OK;
 
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(&session_memory, &cursor);
+
   // Check session is initialized
-  if (NULL == session_memory.allocateditems) {
+  if (NULL == item) {
     RMW_SET_ERROR_MSG("Uninitialized session.");
     return RMW_RET_ERROR;
   }
-
-  rmw_uxrce_mempool_item_t * item = session_memory.allocateditems;
   rmw_context_impl_t * context = (rmw_context_impl_t *)item->data;
 
   if (!uxr_sync_session(&context->session, timeout_ms)) {
@@ -0,0 +1,55 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw/rmw.h>
+#include <rmw/ret_types.h>
+#include <rmw/error_handling.h>
+
+#include "../types.h"
+#include "../utils.h"
+
+rmw_ret_t rmw_uros_set_zero_copy_destination(
+  rmw_subscription_t * subscription,
+  void * ros_message)
+{
+  if (NULL == subscription || NULL == subscription->data) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  if (!is_uxrce_rmw_identifier_valid(subscription->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
+  rmw_ret_t ret = RMW_RET_OK;
+
+  // Setting the destination lends it to the session thread until a take hands it back
+  UXR_LOCK(&static_buffer_memory.mutex);
+  if (RMW_UXRCE_ZERO_COPY_FILLING == custom_subscription->zero_copy_state ||
+    RMW_UXRCE_ZERO_COPY_PENDING == custom_subscription->zero_copy_state)
+  {
+    RMW_SET_ERROR_MSG("a sample is pending in the current zero-copy destination");
+    ret = RMW_RET_ERROR;
+  } else {
+    custom_subscription->zero_copy_destination = ros_message;
+    custom_subscription->zero_copy_state =
+      (NULL != ros_message) ? RMW_UXRCE_ZERO_COPY_LENT : RMW_UXRCE_ZERO_COPY_HELD;
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return ret;
+}
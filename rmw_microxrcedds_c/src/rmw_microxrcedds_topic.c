@@ -21,17 +21,75 @@
 
 #include "./utils.h"
 
+static bool
+same_type(
+  const message_type_support_callbacks_t * a,
+  const message_type_support_callbacks_t * b)
+{
+  if (a == b) {
+    return true;
+  }
+
+  // C and C++ type supports of a type have different callbacks
+  if (0 != strcmp(a->message_name_, b->message_name_)) {
+    return false;
+  }
+  if (NULL == a->message_namespace_ || NULL == b->message_namespace_) {
+    return a->message_namespace_ == b->message_namespace_;
+  }
+  return 0 == strcmp(a->message_namespace_, b->message_namespace_);
+}
+
+static rmw_uxrce_topic_t *
+find_topic(
+  struct rmw_uxrce_node_t * custom_node,
+  const char * topic_name,
+  const message_type_support_callbacks_t * message_type_support_callbacks)
+{
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_mempool_item_t * item = first_memory(&topics_memory, &cursor);
+  while (item != NULL) {
+    rmw_uxrce_topic_t * custom_topic = (rmw_uxrce_topic_t *)item->data;
+    item = next_memory(&topics_memory, &cursor);
+    if (custom_topic->owner_node == custom_node &&
+      0 == strcmp(custom_topic->topic_name, topic_name) &&
+      same_type(custom_topic->message_type_support_callbacks, message_type_support_callbacks))
+    {
+      return custom_topic;
+    }
+  }
+  return NULL;
+}
+
 
 rmw_uxrce_topic_t *
 create_topic(
   struct rmw_uxrce_node_t * custom_node,
   const char * topic_name,
   const message_type_support_callbacks_t * message_type_support_callbacks,
-  const rmw_qos_profile_t * qos_policies)
+  const rmw_qos_profile_t * qos_policies,
+  uint16_t * topic_req,
+  bool * reused)
 {
   (void) qos_policies;
 
-  rmw_uxrce_topic_t * custom_topic = NULL;
+  *topic_req = UXR_INVALID_REQUEST_ID;
+  *reused = false;
+
+  if (strlen(topic_name) > RMW_UXRCE_TOPIC_NAME_MAX_LENGTH) {
+    RMW_SET_ERROR_MSG("topic name too long");
+    return NULL;
+  }
+
+  // An existing topic is reused without any request to the agent
+  rmw_uxrce_topic_t * custom_topic = find_topic(
+    custom_node, topic_name, message_type_support_callbacks);
+  if (NULL != custom_topic) {
+    custom_topic->users++;
+    *reused = true;
+    return custom_topic;
+  }
+
   rmw_uxrce_mempool_item_t * memory_node = get_memory(&topics_memory);
 
   if (!memory_node) {
@@ -43,6 +101,8 @@ create_topic(
 
   // Init
   custom_topic->owner_node = custom_node;
+  snprintf(custom_topic->topic_name, sizeof(custom_topic->topic_name), "%s", topic_name);
+  custom_topic->users = 1;
 
   // Asociate to typesupport
   custom_topic->message_type_support_callbacks = message_type_support_callbacks;
@@ -50,8 +110,7 @@ create_topic(
   // Generate topic id
   custom_topic->topic_id = uxr_object_id(custom_node->context->id_topic++, UXR_TOPIC_ID);
 
-  // Generate request
-  uint16_t topic_req = 0;
+  // Generate request, it is awaited by the caller along with its endpoint requests
 #ifdef RMW_UXRCE_USE_REFS
   (void)qos_policies;
   if (!build_topic_profile(
@@ -64,18 +123,25 @@ create_topic(
     goto fail;
   }
 
-  topic_req = uxr_buffer_create_topic_ref(
+  *topic_req = uxr_buffer_create_topic_ref(
     &custom_node->context->session,
     *custom_node->context->creation_destroy_stream, custom_topic->topic_id,
     custom_node->participant_id, rmw_uxrce_entity_naming_buffer, UXR_REPLACE | UXR_REUSE);
 #else
-  char full_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH];
-  char type_name[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  char full_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH + sizeof("rt")];
+  char type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
 
   generate_topic_name(topic_name, full_topic_name, sizeof(full_topic_name));
-  generate_type_name(message_type_support_callbacks, type_name, sizeof(type_name));
+  const char * type_name = get_type_name(
+    message_type_support_callbacks, type_name_buffer, sizeof(type_name_buffer));
+  if (NULL == type_name) {
+    RMW_SET_ERROR_MSG("failed to generate type name for topic creation");
+    rmw_uxrce_fini_topic_memory(custom_topic);
+    custom_topic = NULL;
+    goto fail;
+  }
 
-  topic_req = uxr_buffer_create_topic_bin(
+  *topic_req = uxr_buffer_create_topic_bin(
     &custom_node->context->session,
     *custom_node->context->creation_destroy_stream,
     custom_topic->topic_id,
@@ -85,21 +151,25 @@ create_topic(
     UXR_REPLACE | UXR_REUSE);
 #endif /* ifdef RMW_UXRCE_USE_XML */
 
-  if (!run_xrce_session(custom_node->context, topic_req)) {
-    rmw_uxrce_fini_topic_memory(custom_topic);
-    custom_topic = NULL;
-    goto fail;
-  }
-
 fail:
   return custom_topic;
 }
 
+void release_topic(
+  rmw_uxrce_topic_t * topic)
+{
+  if (--topic->users == 0) {
+    rmw_uxrce_fini_topic_memory(topic);
+  }
+}
+
 rmw_ret_t destroy_topic(
   rmw_uxrce_topic_t * topic)
 {
   rmw_ret_t result_ret = RMW_RET_OK;
-  if (topic->owner_node != NULL) {
+  if (topic->owner_node != NULL && topic->users > 1) {
+    topic->users--;
+  } else if (topic->owner_node != NULL) {
     rmw_uxrce_node_t * custom_node = topic->owner_node;
 
     uint16_t delete_topic = uxr_buffer_delete_entity(
@@ -122,21 +192,22 @@ size_t topic_count(
   rmw_uxrce_node_t * custom_node)
 {
   size_t count = 0;
+  rmw_uxrce_mempool_cursor_t cursor;
   rmw_uxrce_mempool_item_t * item = NULL;
 
-  item = publisher_memory.allocateditems;
+  item = first_memory(&publisher_memory, &cursor);
   while (item != NULL) {
     rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)item->data;
-    item = item->next;
+    item = next_memory(&publisher_memory, &cursor);
     if (custom_publisher->owner_node == custom_node && custom_publisher->topic != NULL) {
       count++;
     }
   }
 
-  item = subscription_memory.allocateditems;
+  item = first_memory(&subscription_memory, &cursor);
   while (item != NULL) {
     rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)item->data;
-    item = item->next;
+    item = next_memory(&subscription_memory, &cursor);
     if (custom_subscription->owner_node == custom_node && custom_subscription->topic != NULL) {
       count++;
     }
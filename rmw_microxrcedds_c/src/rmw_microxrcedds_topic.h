@@ -30,8 +30,12 @@ create_topic(
   struct rmw_uxrce_node_t * custom_node,
   const char * topic_name,
   const message_type_support_callbacks_t * message_type_support_callbacks,
-  const rmw_qos_profile_t * qos_policies);
+  const rmw_qos_profile_t * qos_policies,
+  uint16_t * topic_req,
+  bool * reused);
 
+void release_topic(
+  rmw_uxrce_topic_t * topic);
 rmw_ret_t destroy_topic(
   rmw_uxrce_topic_t * topic);
 size_t topic_count(
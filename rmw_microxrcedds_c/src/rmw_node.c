@@ -45,6 +45,8 @@ rmw_node_t * create_node(
   rmw_uxrce_node_t * node_info = (rmw_uxrce_node_t *)memory_node->data;
 
   node_info->context = context->impl;
+  node_info->publisher_users = 0;
+  node_info->subscriber_users = 0;
 
   node_handle = rmw_node_allocate();
   if (!node_handle) {
@@ -164,39 +166,40 @@ rmw_ret_t rmw_destroy_node(
   rmw_uxrce_node_t * custom_node = (rmw_uxrce_node_t *)node->data;
   // TODO(Pablo) make sure that other entities are removed from the pools
 
+  rmw_uxrce_mempool_cursor_t cursor;
   rmw_uxrce_mempool_item_t * item = NULL;
 
-  item = publisher_memory.allocateditems;
+  item = first_memory(&publisher_memory, &cursor);
   while (item != NULL) {
     rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)item->data;
-    item = item->next;
+    item = next_memory(&publisher_memory, &cursor);
     if (custom_publisher->owner_node == custom_node) {
       ret = rmw_destroy_publisher(node, custom_publisher->rmw_handle);
     }
   }
 
-  item = subscription_memory.allocateditems;
+  item = first_memory(&subscription_memory, &cursor);
   while (item != NULL) {
     rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)item->data;
-    item = item->next;
+    item = next_memory(&subscription_memory, &cursor);
     if (custom_subscription->owner_node == custom_node) {
       ret = rmw_destroy_subscription(node, custom_subscription->rmw_handle);
     }
   }
 
-  item = service_memory.allocateditems;
+  item = first_memory(&service_memory, &cursor);
   while (item != NULL) {
     rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)item->data;
-    item = item->next;
+    item = next_memory(&service_memory, &cursor);
     if (custom_service->owner_node == custom_node) {
       ret = rmw_destroy_service(node, custom_service->rmw_handle);
     }
   }
 
-  item = client_memory.allocateditems;
+  item = first_memory(&client_memory, &cursor);
   while (item != NULL) {
     rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)item->data;
-    item = item->next;
+    item = next_memory(&client_memory, &cursor);
     if (custom_client->owner_node == custom_node) {
       ret = rmw_destroy_client(node, custom_client->rmw_handle);
     }
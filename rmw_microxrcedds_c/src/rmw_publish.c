@@ -16,6 +16,7 @@
 #include <rmw/rmw.h>
 #include <rmw_microros/rmw_microros.h>
 #include <uxr/client/profile/multithread/multithread.h>
+#include <uxr/client/util/time.h>
 
 #include "./types.h"
 #include "./utils.h"
@@ -26,6 +27,142 @@ bool flush_session(
   return uxr_run_session_until_confirm_delivery(session, RMW_UXRCE_PUBLISH_RELIABLE_TIMEOUT);
 }
 
+static bool
+admit_publication(
+  rmw_uxrce_publisher_t * custom_publisher,
+  uint32_t topic_length,
+  rmw_ret_t * ret)
+{
+  rmw_context_impl_t * context = custom_publisher->owner_node->context;
+  rmw_uxrce_priority_class_t * priority_class =
+    &context->priority_classes[custom_publisher->priority];
+
+  *ret = RMW_RET_OK;
+  if (rmw_uxrce_priority_class_admit(priority_class, topic_length)) {
+    return true;
+  }
+
+  // Best effort samples over budget are dropped, as they could be on the link.
+  // The publication still succeeds, drops are reported by rmw_uros_get_priority_usage
+  if (UXR_BEST_EFFORT_STREAM == custom_publisher->stream_id.type) {
+    priority_class->dropped_samples++;
+    return false;
+  }
+
+  // Reliable ones wait for the budget to refill. The session is not run meanwhile,
+  // so no sample is dispatched from within a publication
+  int64_t deadline = uxr_millis() + RMW_UXRCE_PUBLISH_RELIABLE_TIMEOUT;
+  while (uxr_millis() < deadline) {
+    if (rmw_uxrce_priority_class_admit(priority_class, topic_length)) {
+      return true;
+    }
+  }
+
+  priority_class->dropped_samples++;
+  RMW_SET_ERROR_MSG("priority class budget exhausted");
+  *ret = RMW_RET_TIMEOUT;
+  return false;
+}
+
+static bool
+prepare_publication(
+  rmw_uxrce_publisher_t * custom_publisher,
+  uint32_t topic_length,
+  ucdrBuffer * mb)
+{
+  rmw_context_impl_t * context = custom_publisher->owner_node->context;
+
+  if (uxr_prepare_output_stream(
+      &context->session,
+      custom_publisher->stream_id, custom_publisher->datawriter_id, mb,
+      topic_length))
+  {
+    return true;
+  }
+
+  // A full stream in a batch is sent before the sample is fragmented
+  if (context->publish_batch) {
+    uxr_flash_output_streams(&context->session);
+    if (uxr_prepare_output_stream(
+        &context->session,
+        custom_publisher->stream_id, custom_publisher->datawriter_id, mb,
+        topic_length))
+    {
+      return true;
+    }
+  }
+
+  return uxr_prepare_output_stream_fragmented(
+    &context->session,
+    custom_publisher->stream_id, custom_publisher->datawriter_id, mb,
+    topic_length, flush_session);
+}
+
+static bool
+commit_publication(
+  rmw_uxrce_publisher_t * custom_publisher,
+  uint32_t topic_length)
+{
+  rmw_context_impl_t * context = custom_publisher->owner_node->context;
+  bool reliable = UXR_RELIABLE_STREAM == custom_publisher->stream_id.type;
+
+  if (reliable && custom_publisher->async_reliable) {
+    rmw_uxrce_publisher_push_in_flight(custom_publisher, topic_length);
+  }
+
+  UXR_UNLOCK_STREAM_ID(&context->session, custom_publisher->stream_id);
+
+  if (context->publish_batch) {
+    context->publish_batch_reliable |= reliable && !custom_publisher->async_reliable;
+    return true;
+  }
+
+  // Acknowledgements are processed whenever the session runs again
+  if (!reliable || custom_publisher->async_reliable) {
+    uxr_flash_output_streams(&context->session);
+    return true;
+  }
+
+  return uxr_run_session_until_confirm_delivery(
+    &context->session, RMW_UXRCE_PUBLISH_RELIABLE_TIMEOUT);
+}
+
+static rmw_ret_t
+publish_ros_message(
+  rmw_uxrce_publisher_t * custom_publisher,
+  const void * ros_message)
+{
+  const message_type_support_callbacks_t * functions = custom_publisher->type_support_callbacks;
+  uint32_t topic_length = functions->get_serialized_size(ros_message);
+
+  if (custom_publisher->cs_cb_size) {
+    custom_publisher->cs_cb_size(&topic_length);
+  }
+
+  rmw_ret_t ret = RMW_RET_OK;
+  if (!admit_publication(custom_publisher, topic_length, &ret)) {
+    return ret;
+  }
+
+  // Messages are serialized straight into the output stream
+  ucdrBuffer mb;
+  bool written = false;
+  if (prepare_publication(custom_publisher, topic_length, &mb)) {
+    written = functions->cdr_serialize(ros_message, &mb);
+    if (custom_publisher->cs_cb_serialization) {
+      custom_publisher->cs_cb_serialization(&mb);
+    }
+
+    written &= commit_publication(custom_publisher, topic_length);
+  }
+  if (!written) {
+    RMW_SET_ERROR_MSG("error publishing message");
+    return RMW_RET_ERROR;
+  }
+
+  return RMW_RET_OK;
+}
+
 rmw_ret_t
 rmw_publish(
   const rmw_publisher_t * publisher,
@@ -46,73 +183,91 @@ rmw_publish(
   } else if (!publisher->data) {
     RMW_SET_ERROR_MSG("publisher imp is null");
     ret = RMW_RET_ERROR;
+  } else {
+    ret = publish_ros_message((rmw_uxrce_publisher_t *)publisher->data, ros_message);
+  }
+  return ret;
+}
+
+rmw_ret_t
+rmw_publish_serialized_message(
+  const rmw_publisher_t * publisher,
+  const rmw_serialized_message_t * serialized_message,
+  rmw_publisher_allocation_t * allocation)
+{
+  (void)allocation;
+  rmw_ret_t ret = RMW_RET_OK;
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher pointer is null");
+    ret = RMW_RET_INVALID_ARGUMENT;
+  } else if (!serialized_message) {
+    RMW_SET_ERROR_MSG("serialized_message pointer is null");
+    ret = RMW_RET_INVALID_ARGUMENT;
+  } else if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    ret = RMW_RET_INCORRECT_RMW_IMPLEMENTATION;
+  } else if (!publisher->data) {
+    RMW_SET_ERROR_MSG("publisher imp is null");
+    ret = RMW_RET_ERROR;
   } else {
     rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
-    const message_type_support_callbacks_t * functions = custom_publisher->type_support_callbacks;
-    uint32_t topic_length = functions->get_serialized_size(ros_message);
 
-    if (custom_publisher->cs_cb_size) {
-      custom_publisher->cs_cb_size(&topic_length);
+    if (!admit_publication(
+        custom_publisher, (uint32_t)serialized_message->buffer_length, &ret))
+    {
+      return ret;
     }
 
+    // CDR payload is copied as is into the output stream
     ucdrBuffer mb;
     bool written = false;
-    if (uxr_prepare_output_stream(
-        &custom_publisher->owner_node->context->session,
-        custom_publisher->stream_id, custom_publisher->datawriter_id, &mb,
-        topic_length) ||
-      uxr_prepare_output_stream_fragmented(
-        &custom_publisher->owner_node->context->session,
-        custom_publisher->stream_id, custom_publisher->datawriter_id, &mb,
-        topic_length, flush_session))
+    if (prepare_publication(
+        custom_publisher, (uint32_t)serialized_message->buffer_length, &mb))
     {
-      written = functions->cdr_serialize(ros_message, &mb);
-      if (custom_publisher->cs_cb_serialization) {
-        custom_publisher->cs_cb_serialization(&mb);
-      }
-
-      UXR_UNLOCK_STREAM_ID(
-        &custom_publisher->owner_node->context->session,
-        custom_publisher->stream_id);
-
-      if (UXR_BEST_EFFORT_STREAM == custom_publisher->stream_id.type) {
-        uxr_flash_output_streams(&custom_publisher->owner_node->context->session);
-      } else {
-        written &= uxr_run_session_until_confirm_delivery(
-          &custom_publisher->owner_node->context->session, RMW_UXRCE_PUBLISH_RELIABLE_TIMEOUT);
-      }
+      written = ucdr_serialize_array_uint8_t(
+        &mb, serialized_message->buffer, serialized_message->buffer_length);
+
+      written &= commit_publication(
+        custom_publisher, (uint32_t)serialized_message->buffer_length);
     }
     if (!written) {
-      RMW_SET_ERROR_MSG("error publishing message");
+      RMW_SET_ERROR_MSG("error publishing serialized message");
       ret = RMW_RET_ERROR;
     }
   }
   return ret;
 }
 
-rmw_ret_t
-rmw_publish_serialized_message(
-  const rmw_publisher_t * publisher,
-  const rmw_serialized_message_t * serialized_message,
-  rmw_publisher_allocation_t * allocation)
-{
-  (void)publisher;
-  (void)serialized_message;
-  (void)allocation;
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
-}
-
 rmw_ret_t
 rmw_publish_loaned_message(
   const rmw_publisher_t * publisher,
   void * ros_message,
   rmw_publisher_allocation_t * allocation)
 {
-  (void)publisher;
-  (void)ros_message;
   (void)allocation;
+  rmw_ret_t ret = RMW_RET_OK;
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher pointer is null");
+    ret = RMW_RET_INVALID_ARGUMENT;
+  } else if (!ros_message) {
+    RMW_SET_ERROR_MSG("ros_message pointer is null");
+    ret = RMW_RET_INVALID_ARGUMENT;
+  } else if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    ret = RMW_RET_INCORRECT_RMW_IMPLEMENTATION;
+  } else if (!publisher->can_loan_messages) {
+    RMW_SET_ERROR_MSG("publisher has no loan pool");
+    ret = RMW_RET_UNSUPPORTED;
+  } else {
+    rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
 
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+    // Publishing gives the loan back, the message is serialized before it can be lent again
+    if (!rmw_uxrce_publisher_put_loan(custom_publisher, ros_message)) {
+      RMW_SET_ERROR_MSG("message was not loaned by this publisher");
+      ret = RMW_RET_ERROR;
+    } else {
+      ret = publish_ros_message(custom_publisher, ros_message);
+    }
+  }
+  return ret;
 }
@@ -111,6 +111,17 @@ rmw_create_publisher(
     custom_publisher->cs_cb_size = NULL;
     custom_publisher->cs_cb_serialization = NULL;
 
+    custom_publisher->loan_pool = NULL;
+    custom_publisher->loan_size = 0;
+    custom_publisher->loan_count = 0;
+    custom_publisher->loans_in_use = 0;
+    rmw_publisher->can_loan_messages = false;
+
+    custom_publisher->priority = 0;
+    custom_publisher->async_reliable = false;
+    custom_publisher->in_flight_samples = 0;
+    custom_publisher->in_flight_bytes = 0;
+
     const rosidl_message_type_support_t * type_support_xrce = NULL;
 #ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE
     type_support_xrce = get_message_typesupport_handle(
@@ -135,49 +146,54 @@ rmw_create_publisher(
       goto fail;
     }
 
+    // Topic, publisher and datawriter are requested back to back and awaited at once,
+    // shared entities are not requested again
+    uint16_t requests[3];
+    size_t request_count = 0;
+    bool topic_reused = false;
+
     // Create topic
     custom_publisher->topic = create_topic(
       custom_node, topic_name,
-      custom_publisher->type_support_callbacks, qos_policies);
+      custom_publisher->type_support_callbacks, qos_policies, &requests[request_count],
+      &topic_reused);
 
     if (custom_publisher->topic == NULL) {
       RMW_SET_ERROR_MSG("Error creating topic");
       goto fail;
     }
-
-    // Create publisher
-    custom_publisher->publisher_id = uxr_object_id(
-      custom_node->context->id_publisher++,
-      UXR_PUBLISHER_ID);
-    uint16_t publisher_req = UXR_INVALID_REQUEST_ID;
-
-  #ifdef RMW_UXRCE_USE_REFS
-    publisher_req = uxr_buffer_create_publisher_xml(
-      &custom_publisher->owner_node->context->session,
-      *custom_node->context->creation_destroy_stream,
-      custom_publisher->publisher_id,
-      custom_node->participant_id, "", UXR_REPLACE | UXR_REUSE);
-  #else
-    publisher_req = uxr_buffer_create_publisher_bin(
-      &custom_publisher->owner_node->context->session,
-      *custom_node->context->creation_destroy_stream,
-      custom_publisher->publisher_id,
-      custom_node->participant_id,
-      UXR_REPLACE | UXR_REUSE);
-  #endif /* ifdef RMW_UXRCE_USE_REFS */
-
-    if (!run_xrce_session(custom_node->context, publisher_req)) {
-      put_memory(&publisher_memory, &custom_publisher->mem);
-      goto fail;
+    if (!topic_reused) {
+      request_count++;
     }
 
-    rmw_publisher->data = custom_publisher;
+    // Create publisher, only for the first datawriter of the node
+    if (0 == custom_node->publisher_users) {
+      custom_node->publisher_id = uxr_object_id(
+        custom_node->context->id_publisher++,
+        UXR_PUBLISHER_ID);
+
+    #ifdef RMW_UXRCE_USE_REFS
+      requests[request_count++] = uxr_buffer_create_publisher_xml(
+        &custom_publisher->owner_node->context->session,
+        *custom_node->context->creation_destroy_stream,
+        custom_node->publisher_id,
+        custom_node->participant_id, "", UXR_REPLACE | UXR_REUSE);
+    #else
+      requests[request_count++] = uxr_buffer_create_publisher_bin(
+        &custom_publisher->owner_node->context->session,
+        *custom_node->context->creation_destroy_stream,
+        custom_node->publisher_id,
+        custom_node->participant_id,
+        UXR_REPLACE | UXR_REUSE);
+    #endif /* ifdef RMW_UXRCE_USE_REFS */
+    }
+    custom_node->publisher_users++;
+    custom_publisher->publisher_id = custom_node->publisher_id;
 
     // Create datawriter
     custom_publisher->datawriter_id = uxr_object_id(
       custom_node->context->id_datawriter++,
       UXR_DATAWRITER_ID);
-    uint16_t datawriter_req = UXR_INVALID_REQUEST_ID;
 
   #ifdef RMW_UXRCE_USE_REFS
     if (!build_datawriter_profile(
@@ -185,10 +201,13 @@ rmw_create_publisher(
         sizeof(rmw_uxrce_entity_naming_buffer)))
     {
       RMW_SET_ERROR_MSG("failed to generate xml request for node creation");
+      release_topic(custom_publisher->topic);
+      custom_node->publisher_users--;
+      put_memory(&publisher_memory, &custom_publisher->mem);
       goto fail;
     }
 
-    datawriter_req = uxr_buffer_create_datawriter_ref(
+    requests[request_count++] = uxr_buffer_create_datawriter_ref(
       &custom_publisher->owner_node->context->session,
       *custom_node->context->creation_destroy_stream,
       custom_publisher->datawriter_id,
@@ -211,7 +230,7 @@ rmw_create_publisher(
         break;
     }
 
-    datawriter_req = uxr_buffer_create_datawriter_bin(
+    requests[request_count++] = uxr_buffer_create_datawriter_bin(
       &custom_publisher->owner_node->context->session,
       *custom_node->context->creation_destroy_stream,
       custom_publisher->datawriter_id,
@@ -223,10 +242,14 @@ rmw_create_publisher(
       UXR_REPLACE | UXR_REUSE);
   #endif /* ifdef RMW_UXRCE_USE_REFS */
 
-    if (!run_xrce_session(custom_node->context, datawriter_req)) {
+    if (!run_xrce_session_all(custom_node->context, requests, request_count)) {
+      release_topic(custom_publisher->topic);
+      custom_node->publisher_users--;
       put_memory(&publisher_memory, &custom_publisher->mem);
       goto fail;
     }
+
+    rmw_publisher->data = custom_publisher;
   }
 
   return rmw_publisher;
@@ -307,12 +330,51 @@ rmw_borrow_loaned_message(
   const rosidl_message_type_support_t * type_support,
   void ** ros_message)
 {
-  (void)publisher;
-  (void)type_support;
-  (void)ros_message;
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher pointer is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  } else if (!type_support) {
+    RMW_SET_ERROR_MSG("type support is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  } else if (!ros_message || *ros_message) {
+    RMW_SET_ERROR_MSG("ros_message must point to a null pointer");
+    return RMW_RET_INVALID_ARGUMENT;
+  } else if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION;
+  } else if (!publisher->can_loan_messages) {
+    RMW_SET_ERROR_MSG("publisher has no loan pool");
+    return RMW_RET_UNSUPPORTED;
+  }
 
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
+
+  // The loan pool is sized for the type the publisher was created with
+  const rosidl_message_type_support_t * type_support_xrce = NULL;
+#ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE
+  type_support_xrce = get_message_typesupport_handle(
+    type_support, ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE);
+#endif /* ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE */
+#ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_CPP__IDENTIFIER_VALUE
+  if (NULL == type_support_xrce) {
+    type_support_xrce = get_message_typesupport_handle(
+      type_support, ROSIDL_TYPESUPPORT_MICROXRCEDDS_CPP__IDENTIFIER_VALUE);
+  }
+#endif /* ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_CPP__IDENTIFIER_VALUE */
+  if (NULL == type_support_xrce ||
+    type_support_xrce->data != (const void *)custom_publisher->type_support_callbacks)
+  {
+    RMW_SET_ERROR_MSG("type support does not match the publisher");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  *ros_message = rmw_uxrce_publisher_get_loan(custom_publisher);
+  if (NULL == *ros_message) {
+    RMW_SET_ERROR_MSG("all loaned messages are in use");
+    return RMW_RET_ERROR;
+  }
+
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -320,11 +382,28 @@ rmw_return_loaned_message_from_publisher(
   const rmw_publisher_t * publisher,
   void * loaned_message)
 {
-  (void)publisher;
-  (void)loaned_message;
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher pointer is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  } else if (!loaned_message) {
+    RMW_SET_ERROR_MSG("loaned message is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  } else if (!is_uxrce_rmw_identifier_valid(publisher->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION;
+  } else if (!publisher->can_loan_messages) {
+    RMW_SET_ERROR_MSG("publisher has no loan pool");
+    return RMW_RET_UNSUPPORTED;
+  }
 
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  rmw_uxrce_publisher_t * custom_publisher = (rmw_uxrce_publisher_t *)publisher->data;
+
+  if (!rmw_uxrce_publisher_put_loan(custom_publisher, loaned_message)) {
+    RMW_SET_ERROR_MSG("message was not loaned by this publisher");
+    return RMW_RET_ERROR;
+  }
+
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -357,18 +436,22 @@ rmw_destroy_publisher(
 
     destroy_topic(custom_publisher->topic);
 
-    uint16_t delete_writer = uxr_buffer_delete_entity(
+    uint16_t delete_requests[2];
+    size_t delete_count = 0;
+    delete_requests[delete_count++] = uxr_buffer_delete_entity(
       &custom_publisher->owner_node->context->session,
       *custom_publisher->owner_node->context->creation_destroy_stream,
       custom_publisher->datawriter_id);
-    uint16_t delete_publisher = uxr_buffer_delete_entity(
-      &custom_publisher->owner_node->context->session,
-      *custom_publisher->owner_node->context->creation_destroy_stream,
-      custom_publisher->publisher_id);
 
-    bool ret = run_xrce_session(custom_node->context, delete_writer);
-    ret &= run_xrce_session(custom_node->context, delete_publisher);
-    if (!ret) {
+    // The node publisher goes away with its last datawriter
+    if (0 == --custom_node->publisher_users) {
+      delete_requests[delete_count++] = uxr_buffer_delete_entity(
+        &custom_publisher->owner_node->context->session,
+        *custom_publisher->owner_node->context->creation_destroy_stream,
+        custom_publisher->publisher_id);
+    }
+
+    if (!run_xrce_session_all(custom_node->context, delete_requests, delete_count)) {
       result_ret = RMW_RET_TIMEOUT;
     }
 
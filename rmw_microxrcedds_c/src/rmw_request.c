@@ -53,7 +53,9 @@ rmw_send_request(
 
   UXR_UNLOCK_STREAM_ID(&custom_node->context->session, custom_client->stream_id);
 
-  if (UXR_BEST_EFFORT_STREAM == custom_client->stream_id.type) {
+  if (UXR_BEST_EFFORT_STREAM == custom_client->stream_id.type ||
+    custom_client->async_reliable)
+  {
     uxr_flash_output_streams(&custom_node->context->session);
   } else {
     uxr_run_session_until_confirm_delivery(
@@ -81,16 +83,13 @@ rmw_take_request(
 
   rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)service->data;
 
-  // Find first related item in static buffer memory pool
-  rmw_uxrce_mempool_item_t * static_buffer_item =
-    rmw_uxrce_find_static_input_buffer_by_owner((void *) custom_service);
-  if (static_buffer_item == NULL) {
+  // Take the oldest pending request
+  rmw_uxrce_static_input_buffer_t * static_buffer =
+    rmw_uxrce_input_queue_pop(&custom_service->input_queue);
+  if (static_buffer == NULL) {
     return RMW_RET_ERROR;
   }
 
-  rmw_uxrce_static_input_buffer_t * static_buffer =
-    (rmw_uxrce_static_input_buffer_t *)static_buffer_item->data;
-
   // Conversion from SampleIdentity to rmw_request_id_t
   request_header->request_id.sequence_number =
     (((int64_t)static_buffer->related.sample_id.sequence_number.high) << 32) |
@@ -119,7 +118,7 @@ rmw_take_request(
 
   bool deserialize_rv = functions->cdr_deserialize(&temp_buffer, ros_request);
 
-  put_memory(&static_buffer_memory, static_buffer_item);
+  rmw_uxrce_put_static_input_buffer(static_buffer);
 
   if (taken != NULL) {
     *taken = deserialize_rv;
@@ -67,7 +67,9 @@ rmw_send_response(
 
   UXR_UNLOCK_STREAM_ID(&custom_node->context->session, custom_service->stream_id);
 
-  if (UXR_BEST_EFFORT_STREAM == custom_service->stream_id.type) {
+  if (UXR_BEST_EFFORT_STREAM == custom_service->stream_id.type ||
+    custom_service->async_reliable)
+  {
     uxr_flash_output_streams(&custom_node->context->session);
   } else {
     uxr_run_session_until_confirm_delivery(
@@ -95,16 +97,13 @@ rmw_take_response(
 
   rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)client->data;
 
-  // Find first related item in static buffer memory pool
-  rmw_uxrce_mempool_item_t * static_buffer_item =
-    rmw_uxrce_find_static_input_buffer_by_owner((void *) custom_client);
-  if (static_buffer_item == NULL) {
+  // Take the oldest pending response
+  rmw_uxrce_static_input_buffer_t * static_buffer =
+    rmw_uxrce_input_queue_pop(&custom_client->input_queue);
+  if (static_buffer == NULL) {
     return RMW_RET_ERROR;
   }
 
-  rmw_uxrce_static_input_buffer_t * static_buffer =
-    (rmw_uxrce_static_input_buffer_t *)static_buffer_item->data;
-
   request_header->request_id.sequence_number = static_buffer->related.reply_id;
 
   const rosidl_message_type_support_t * res_members =
@@ -122,7 +121,7 @@ rmw_take_response(
     &temp_buffer,
     ros_response);
 
-  put_memory(&static_buffer_memory, static_buffer_item);
+  rmw_uxrce_put_static_input_buffer(static_buffer);
 
   if (taken != NULL) {
     *taken = deserialize_rv;
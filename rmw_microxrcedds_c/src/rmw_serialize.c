@@ -14,6 +14,32 @@
 
 #include <rmw/rmw.h>
 #include <rmw/error_handling.h>
+#include <rmw/serialized_message.h>
+
+#include "./types.h"
+
+static const message_type_support_callbacks_t *
+get_message_callbacks(
+  const rosidl_message_type_support_t * type_support)
+{
+  const rosidl_message_type_support_t * type_support_xrce = NULL;
+#ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE
+  type_support_xrce = get_message_typesupport_handle(
+    type_support, ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE);
+#endif /* ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE */
+#ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_CPP__IDENTIFIER_VALUE
+  if (NULL == type_support_xrce) {
+    type_support_xrce = get_message_typesupport_handle(
+      type_support, ROSIDL_TYPESUPPORT_MICROXRCEDDS_CPP__IDENTIFIER_VALUE);
+  }
+#endif /* ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_CPP__IDENTIFIER_VALUE */
+  if (NULL == type_support_xrce || NULL == type_support_xrce->data) {
+    RMW_SET_ERROR_MSG("Undefined type support");
+    return NULL;
+  }
+
+  return (const message_type_support_callbacks_t *)type_support_xrce->data;
+}
 
 rmw_ret_t
 rmw_serialize(
@@ -21,11 +47,34 @@ rmw_serialize(
   const rosidl_message_type_support_t * type_support,
   rmw_serialized_message_t * serialized_message)
 {
-  (void)ros_message;
-  (void)type_support;
-  (void)serialized_message;
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(ros_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+
+  const message_type_support_callbacks_t * functions = get_message_callbacks(type_support);
+  if (NULL == functions) {
+    return RMW_RET_ERROR;
+  }
+
+  // Same CDR payload as published, without encapsulation header
+  uint32_t topic_length = functions->get_serialized_size(ros_message);
+  if (serialized_message->buffer_capacity < topic_length &&
+    RMW_RET_OK != rmw_serialized_message_resize(serialized_message, topic_length))
+  {
+    RMW_SET_ERROR_MSG("Serialized message resize error.");
+    return RMW_RET_BAD_ALLOC;
+  }
+
+  ucdrBuffer mb;
+  ucdr_init_buffer(&mb, serialized_message->buffer, topic_length);
+  if (!functions->cdr_serialize(ros_message, &mb)) {
+    RMW_SET_ERROR_MSG("Typesupport serialize error.");
+    return RMW_RET_ERROR;
+  }
+
+  serialized_message->buffer_length = topic_length;
+
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -34,11 +83,23 @@ rmw_deserialize(
   const rosidl_message_type_support_t * type_support,
   void * ros_message)
 {
-  (void)serialized_message;
-  (void)type_support;
-  (void)ros_message;
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(ros_message, RMW_RET_INVALID_ARGUMENT);
+
+  const message_type_support_callbacks_t * functions = get_message_callbacks(type_support);
+  if (NULL == functions) {
+    return RMW_RET_ERROR;
+  }
+
+  ucdrBuffer mb;
+  ucdr_init_buffer(&mb, serialized_message->buffer, serialized_message->buffer_length);
+  if (!functions->cdr_deserialize(&mb, ros_message)) {
+    RMW_SET_ERROR_MSG("Typesupport desserialize error.");
+    return RMW_RET_ERROR;
+  }
+
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -50,6 +111,9 @@ rmw_get_serialized_message_size(
   (void)type_support;
   (void)message_bounds;
   (void)size;
+
+  // max_serialized_size leaves unbounded strings and sequences out and does not tell
+  // which types have them, so no safe worst case can be reported
   RMW_SET_ERROR_MSG("function not implemented");
   return RMW_RET_UNSUPPORTED;
 }
@@ -68,6 +68,8 @@ rmw_create_service(
     custom_service->rmw_handle = rmw_service;
 
     custom_service->owner_node = custom_node;
+    rmw_uxrce_input_queue_init(&custom_service->input_queue);
+    custom_service->async_reliable = false;
     custom_service->history_write_index = 0;
     custom_service->history_read_index = 0;
 
@@ -95,7 +97,10 @@ rmw_create_service(
       goto fail;
     }
 
-    custom_service->service_id = uxr_object_id(custom_node->context->id_replier++, UXR_REPLIER_ID);
+    custom_service->service_id = rmw_uxrce_entity_table_next_id(
+      &custom_node->context->service_table,
+      &custom_node->context->id_replier,
+      UXR_REPLIER_ID);
 
     uint16_t service_req = UXR_INVALID_REQUEST_ID;
 
@@ -121,9 +126,13 @@ rmw_create_service(
 #else
     char req_type_name[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
     char res_type_name[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
-    generate_service_types(
-      custom_service->type_support_callbacks, req_type_name, res_type_name,
-      RMW_UXRCE_TYPE_NAME_MAX_LENGTH);
+    if (!generate_service_types(
+        custom_service->type_support_callbacks, req_type_name, res_type_name,
+        RMW_UXRCE_TYPE_NAME_MAX_LENGTH))
+    {
+      RMW_SET_ERROR_MSG("failed to generate type names for service creation");
+      goto fail;
+    }
 
     char req_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH];
     char res_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH];
@@ -168,6 +177,10 @@ rmw_create_service(
       custom_node->context->best_effort_input :
       custom_node->context->reliable_input;
 
+    rmw_uxrce_entity_table_insert(
+      &custom_node->context->service_table,
+      custom_service->service_id, custom_service);
+
     custom_service->service_data_resquest = uxr_buffer_request_data(
       &custom_node->context->session,
       *custom_node->context->creation_destroy_stream, custom_service->service_id,
@@ -208,6 +221,11 @@ rmw_destroy_service(
   } else {
     rmw_uxrce_node_t * custom_node = (rmw_uxrce_node_t *)node->data;
     rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)service->data;
+
+    rmw_uxrce_entity_table_remove(
+      &custom_node->context->service_table,
+      custom_service->service_id, custom_service);
+
     uint16_t delete_service =
       uxr_buffer_delete_entity(
       &custom_node->context->session,
@@ -103,7 +103,16 @@ rmw_create_subscription(
     custom_subscription->rmw_handle = rmw_subscription;
 
     custom_subscription->owner_node = custom_node;
+    rmw_uxrce_input_queue_init(&custom_subscription->input_queue);
+    custom_subscription->zero_copy_destination = NULL;
+    custom_subscription->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+    custom_subscription->loan_size = 0;
+    custom_subscription->loans = NULL;
+    rmw_subscription->can_loan_messages = false;
     memcpy(&custom_subscription->qos, qos_policies, sizeof(rmw_qos_profile_t));
+    rmw_uxrce_input_queue_set_depth(
+      &custom_subscription->input_queue,
+      (RMW_QOS_POLICY_HISTORY_KEEP_LAST == qos_policies->history) ? qos_policies->depth : 0);
 
     const rosidl_message_type_support_t * type_support_xrce = NULL;
 #ifdef ROSIDL_TYPESUPPORT_MICROXRCEDDS_C__IDENTIFIER_VALUE
@@ -129,44 +138,52 @@ rmw_create_subscription(
       goto fail;
     }
 
+    // Topic, subscriber and datareader are requested back to back and awaited at once,
+    // shared entities are not requested again
+    uint16_t requests[3];
+    size_t request_count = 0;
+    bool topic_reused = false;
+
     // Create topic
     custom_subscription->topic = create_topic(
       custom_node, topic_name,
-      custom_subscription->type_support_callbacks, qos_policies);
+      custom_subscription->type_support_callbacks, qos_policies, &requests[request_count],
+      &topic_reused);
     if (custom_subscription->topic == NULL) {
       goto fail;
     }
+    if (!topic_reused) {
+      request_count++;
+    }
 
-    // Create subscriber
-    custom_subscription->subscriber_id = uxr_object_id(
-      custom_node->context->id_subscriber++,
-      UXR_SUBSCRIBER_ID);
-    uint16_t subscriber_req = UXR_INVALID_REQUEST_ID;
+    // Create subscriber, only for the first datareader of the node
+    if (0 == custom_node->subscriber_users) {
+      custom_node->subscriber_id = uxr_object_id(
+        custom_node->context->id_subscriber++,
+        UXR_SUBSCRIBER_ID);
 
 #ifdef RMW_UXRCE_USE_REFS
-    subscriber_req = uxr_buffer_create_subscriber_xml(
-      &custom_node->context->session,
-      *custom_node->context->creation_destroy_stream, custom_subscription->subscriber_id,
-      custom_node->participant_id, "", UXR_REPLACE | UXR_REUSE);
+      requests[request_count++] = uxr_buffer_create_subscriber_xml(
+        &custom_node->context->session,
+        *custom_node->context->creation_destroy_stream, custom_node->subscriber_id,
+        custom_node->participant_id, "", UXR_REPLACE | UXR_REUSE);
 #else
-    subscriber_req = uxr_buffer_create_subscriber_bin(
-      &custom_node->context->session,
-      *custom_node->context->creation_destroy_stream,
-      custom_subscription->subscriber_id,
-      custom_node->participant_id,
-      UXR_REPLACE | UXR_REUSE);
+      requests[request_count++] = uxr_buffer_create_subscriber_bin(
+        &custom_node->context->session,
+        *custom_node->context->creation_destroy_stream,
+        custom_node->subscriber_id,
+        custom_node->participant_id,
+        UXR_REPLACE | UXR_REUSE);
 #endif /* ifdef RMW_UXRCE_USE_REFS */
-
-    if (!run_xrce_session(custom_node->context, subscriber_req)) {
-      put_memory(&subscription_memory, &custom_subscription->mem);
-      goto fail;
     }
+    custom_node->subscriber_users++;
+    custom_subscription->subscriber_id = custom_node->subscriber_id;
 
     // Create datareader
-    custom_subscription->datareader_id = uxr_object_id(
-      custom_node->context->id_datareader++,
+    custom_subscription->datareader_id = rmw_uxrce_entity_table_next_id(
+      &custom_node->context->subscription_table,
+      &custom_node->context->id_datareader,
       UXR_DATAREADER_ID);
-    uint16_t datareader_req = UXR_INVALID_REQUEST_ID;
 
 #ifdef RMW_UXRCE_USE_REFS
     if (!build_datareader_profile(
@@ -174,10 +191,13 @@ rmw_create_subscription(
         sizeof(rmw_uxrce_entity_naming_buffer)))
     {
       RMW_SET_ERROR_MSG("failed to generate xml request for node creation");
+      release_topic(custom_subscription->topic);
+      custom_node->subscriber_users--;
+      put_memory(&subscription_memory, &custom_subscription->mem);
       goto fail;
     }
 
-    datareader_req = uxr_buffer_create_datareader_ref(
+    requests[request_count++] = uxr_buffer_create_datareader_ref(
       &custom_node->context->session,
       *custom_node->context->creation_destroy_stream, custom_subscription->datareader_id,
       custom_subscription->subscriber_id, rmw_uxrce_entity_naming_buffer, UXR_REPLACE | UXR_REUSE);
@@ -199,7 +219,7 @@ rmw_create_subscription(
         break;
     }
 
-    datareader_req = uxr_buffer_create_datareader_bin(
+    requests[request_count++] = uxr_buffer_create_datareader_bin(
       &custom_node->context->session,
       *custom_node->context->creation_destroy_stream,
       custom_subscription->datareader_id,
@@ -211,8 +231,10 @@ rmw_create_subscription(
       UXR_REPLACE | UXR_REUSE);
 #endif /* ifdef RMW_UXRCE_USE_XML */
 
-    if (!run_xrce_session(custom_node->context, datareader_req)) {
+    if (!run_xrce_session_all(custom_node->context, requests, request_count)) {
       RMW_SET_ERROR_MSG("Issues creating Micro XRCE-DDS entities");
+      release_topic(custom_subscription->topic);
+      custom_node->subscriber_users--;
       put_memory(&subscription_memory, &custom_subscription->mem);
       goto fail;
     }
@@ -230,6 +252,10 @@ rmw_create_subscription(
       custom_node->context->best_effort_input :
       custom_node->context->reliable_input;
 
+    rmw_uxrce_entity_table_insert(
+      &custom_node->context->subscription_table,
+      custom_subscription->datareader_id, custom_subscription);
+
     uxr_buffer_request_data(
       &custom_node->context->session,
       *custom_node->context->creation_destroy_stream, custom_subscription->datareader_id,
@@ -327,22 +353,30 @@ rmw_destroy_subscription(
     rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
     rmw_uxrce_node_t * custom_node = custom_subscription->owner_node;
 
+    rmw_uxrce_entity_table_remove(
+      &custom_node->context->subscription_table,
+      custom_subscription->datareader_id, custom_subscription);
+
     destroy_topic(custom_subscription->topic);
 
-    uint16_t delete_datareader =
+    uint16_t delete_requests[2];
+    size_t delete_count = 0;
+    delete_requests[delete_count++] =
       uxr_buffer_delete_entity(
       &custom_subscription->owner_node->context->session,
       *custom_subscription->owner_node->context->creation_destroy_stream,
       custom_subscription->datareader_id);
-    uint16_t delete_subscriber =
-      uxr_buffer_delete_entity(
-      &custom_subscription->owner_node->context->session,
-      *custom_subscription->owner_node->context->creation_destroy_stream,
-      custom_subscription->subscriber_id);
 
-    bool ret = run_xrce_session(custom_node->context, delete_datareader);
-    ret &= run_xrce_session(custom_node->context, delete_subscriber);
-    if (!ret) {
+    // The node subscriber goes away with its last datareader
+    if (0 == --custom_node->subscriber_users) {
+      delete_requests[delete_count++] =
+        uxr_buffer_delete_entity(
+        &custom_subscription->owner_node->context->session,
+        *custom_subscription->owner_node->context->creation_destroy_stream,
+        custom_subscription->subscriber_id);
+    }
+
+    if (!run_xrce_session_all(custom_node->context, delete_requests, delete_count)) {
       result_ret = RMW_RET_TIMEOUT;
     }
     rmw_uxrce_fini_subscription_memory(subscription);
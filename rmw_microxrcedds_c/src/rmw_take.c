@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string.h>
+
 #include <rmw/rmw.h>
 #include <rmw/error_handling.h>
+#include <rmw/serialized_message.h>
 
 #include "./utils.h"
 
@@ -27,6 +30,81 @@ rmw_take(
   return rmw_take_with_info(subscription, ros_message, taken, NULL, allocation);
 }
 
+static void
+fill_message_info(
+  rmw_message_info_t * message_info,
+  int64_t timestamp)
+{
+  if (message_info != NULL) {
+    // Micro XRCE-DDS does not deliver writer information along with the sample
+    memset(message_info, 0, sizeof(rmw_message_info_t));
+    message_info->received_timestamp = timestamp;
+    message_info->publisher_gid.implementation_identifier = rmw_get_implementation_identifier();
+    message_info->from_intra_process = false;
+  }
+}
+
+static bool
+is_zero_copy_destination(
+  rmw_uxrce_subscription_t * custom_subscription,
+  void * ros_message)
+{
+  return NULL != custom_subscription->zero_copy_destination &&
+         ros_message == custom_subscription->zero_copy_destination;
+}
+
+static rmw_uxrce_zero_copy_state_t
+hand_back_zero_copy_destination(
+  rmw_uxrce_subscription_t * custom_subscription)
+{
+  // A destination being filled is left to the session thread, as there is nothing to take yet
+  UXR_LOCK(&static_buffer_memory.mutex);
+  rmw_uxrce_zero_copy_state_t state = custom_subscription->zero_copy_state;
+  if (RMW_UXRCE_ZERO_COPY_FILLING != state) {
+    custom_subscription->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+  }
+  if (RMW_UXRCE_ZERO_COPY_PENDING == state) {
+    rmw_uxrce_input_queue_set_ready(
+      &custom_subscription->input_queue,
+      rmw_uxrce_input_queue_has_data(&custom_subscription->input_queue));
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return state;
+}
+
+static void
+lend_zero_copy_destination(
+  rmw_uxrce_subscription_t * custom_subscription)
+{
+  // A take into the destination that found nothing lends it again
+  UXR_LOCK(&static_buffer_memory.mutex);
+  if (RMW_UXRCE_ZERO_COPY_HELD == custom_subscription->zero_copy_state) {
+    custom_subscription->zero_copy_state = RMW_UXRCE_ZERO_COPY_LENT;
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+}
+
+static bool
+deserialize_static_buffer(
+  rmw_uxrce_subscription_t * custom_subscription,
+  rmw_uxrce_static_input_buffer_t * static_buffer,
+  void * ros_message,
+  rmw_message_info_t * message_info)
+{
+  ucdrBuffer temp_buffer;
+  ucdr_init_buffer(
+    &temp_buffer,
+    static_buffer->buffer,
+    static_buffer->length);
+
+  fill_message_info(message_info, static_buffer->timestamp);
+
+  return custom_subscription->type_support_callbacks->cdr_deserialize(
+    &temp_buffer,
+    ros_message);
+}
+
 rmw_ret_t
 rmw_take_with_info(
   const rmw_subscription_t * subscription,
@@ -35,7 +113,6 @@ rmw_take_with_info(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation)
 {
-  (void)message_info;
   (void)allocation;
 
   if (taken != NULL) {
@@ -48,28 +125,39 @@ rmw_take_with_info(
   }
 
   rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
-
-  // Find first related item in static buffer memory pool
-  rmw_uxrce_mempool_item_t * static_buffer_item = rmw_uxrce_find_static_input_buffer_by_owner(
-    (void *) custom_subscription);
-  if (static_buffer_item == NULL) {
+  bool into_destination = is_zero_copy_destination(custom_subscription, ros_message);
+
+  // A sample held in the zero-copy destination is always older than the queued ones
+  if (into_destination) {
+    rmw_uxrce_zero_copy_state_t state = hand_back_zero_copy_destination(custom_subscription);
+    if (RMW_UXRCE_ZERO_COPY_PENDING == state) {
+      fill_message_info(message_info, custom_subscription->zero_copy_timestamp);
+      if (taken != NULL) {
+        *taken = true;
+      }
+      return RMW_RET_OK;
+    } else if (RMW_UXRCE_ZERO_COPY_FILLING == state) {
+      return RMW_RET_ERROR;
+    }
+  } else if (RMW_UXRCE_ZERO_COPY_PENDING == custom_subscription->zero_copy_state) {
+    RMW_SET_ERROR_MSG("Zero-copy sample pending, take into the registered destination.");
     return RMW_RET_ERROR;
   }
 
+  // Take the oldest pending sample
   rmw_uxrce_static_input_buffer_t * static_buffer =
-    (rmw_uxrce_static_input_buffer_t *)static_buffer_item->data;
-
-  ucdrBuffer temp_buffer;
-  ucdr_init_buffer(
-    &temp_buffer,
-    static_buffer->buffer,
-    static_buffer->length);
+    rmw_uxrce_input_queue_pop(&custom_subscription->input_queue);
+  if (static_buffer == NULL) {
+    if (into_destination) {
+      lend_zero_copy_destination(custom_subscription);
+    }
+    return RMW_RET_ERROR;
+  }
 
-  bool deserialize_rv = custom_subscription->type_support_callbacks->cdr_deserialize(
-    &temp_buffer,
-    ros_message);
+  bool deserialize_rv = deserialize_static_buffer(
+    custom_subscription, static_buffer, ros_message, message_info);
 
-  put_memory(&static_buffer_memory, static_buffer_item);
+  rmw_uxrce_put_static_input_buffer(static_buffer);
 
   if (taken != NULL) {
     *taken = deserialize_rv;
@@ -92,8 +180,12 @@ rmw_take_sequence(
   size_t * taken,
   rmw_subscription_allocation_t * allocation)
 {
-  bool taken_flag;
-  rmw_ret_t ret = RMW_RET_OK;
+  (void)allocation;
+
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(message_sequence, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(message_info_sequence, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
 
   *taken = 0;
 
@@ -102,24 +194,60 @@ rmw_take_sequence(
     return RMW_RET_ERROR;
   }
 
-  for (size_t i = 0; i < count; i++) {
-    taken_flag = false;
-
-    ret = rmw_take_with_info(
-      subscription,
-      message_sequence->data[*taken],
-      &taken_flag,
-      &message_info_sequence->data[*taken],
-      allocation
-    );
+  if (0u == count ||
+    count > message_sequence->capacity ||
+    count > message_info_sequence->capacity)
+  {
+    RMW_SET_ERROR_MSG("Invalid sequence take count");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
 
-    if (ret != RMW_RET_OK || !taken_flag) {
-      break;
+  rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
+  rmw_ret_t ret = RMW_RET_OK;
+  bool into_destination =
+    is_zero_copy_destination(custom_subscription, message_sequence->data[0]);
+
+  // Without the destination first, the queued samples are copied and the one it holds,
+  // if any, is left for a later take into it
+  if (into_destination) {
+    rmw_uxrce_zero_copy_state_t state = hand_back_zero_copy_destination(custom_subscription);
+    if (RMW_UXRCE_ZERO_COPY_PENDING == state) {
+      fill_message_info(
+        &message_info_sequence->data[0], custom_subscription->zero_copy_timestamp);
+      (*taken)++;
+    } else if (RMW_UXRCE_ZERO_COPY_FILLING == state) {
+      message_sequence->size = 0;
+      message_info_sequence->size = 0;
+      return RMW_RET_OK;
     }
+  }
 
+  // Detach every sample to take at once and release them together afterwards
+  size_t batch_count = 0;
+  rmw_uxrce_static_input_buffer_t * batch = rmw_uxrce_input_queue_pop_batch(
+    &custom_subscription->input_queue, count - *taken, &batch_count);
+
+  for (rmw_uxrce_static_input_buffer_t * static_buffer = batch;
+    static_buffer != NULL;
+    static_buffer = static_buffer->queue_next)
+  {
+    if (!deserialize_static_buffer(
+        custom_subscription, static_buffer,
+        message_sequence->data[*taken], &message_info_sequence->data[*taken]))
+    {
+      RMW_SET_ERROR_MSG("Typesupport desserialize error.");
+      ret = RMW_RET_ERROR;
+      continue;
+    }
     (*taken)++;
   }
 
+  rmw_uxrce_put_static_input_buffer_list(batch);
+
+  if (into_destination && 0u == *taken) {
+    lend_zero_copy_destination(custom_subscription);
+  }
+
   message_sequence->size = *taken;
   message_info_sequence->size = *taken;
 
@@ -133,12 +261,8 @@ rmw_take_serialized_message(
   bool * taken,
   rmw_subscription_allocation_t * allocation)
 {
-  (void)subscription;
-  (void)serialized_message;
-  (void)taken;
-  (void)allocation;
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  return rmw_take_serialized_message_with_info(
+    subscription, serialized_message, taken, NULL, allocation);
 }
 
 rmw_ret_t
@@ -149,13 +273,50 @@ rmw_take_serialized_message_with_info(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation)
 {
-  (void)subscription;
-  (void)serialized_message;
-  (void)taken;
-  (void)message_info;
   (void)allocation;
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
+
+  *taken = false;
+
+  if (!is_uxrce_rmw_identifier_valid(subscription->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("Wrong implementation");
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION;
+  }
+
+  rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
+
+  if (RMW_UXRCE_ZERO_COPY_PENDING == custom_subscription->zero_copy_state) {
+    RMW_SET_ERROR_MSG("Zero-copy sample pending, take into the registered destination.");
+    return RMW_RET_ERROR;
+  }
+
+  rmw_uxrce_static_input_buffer_t * static_buffer =
+    rmw_uxrce_input_queue_pop(&custom_subscription->input_queue);
+  if (static_buffer == NULL) {
+    return RMW_RET_ERROR;
+  }
+
+  // CDR payload is handed over as received
+  if (serialized_message->buffer_capacity < static_buffer->length &&
+    RMW_RET_OK != rmw_serialized_message_resize(serialized_message, static_buffer->length))
+  {
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+    RMW_SET_ERROR_MSG("Serialized message resize error.");
+    return RMW_RET_BAD_ALLOC;
+  }
+
+  memcpy(serialized_message->buffer, static_buffer->buffer, static_buffer->length);
+  serialized_message->buffer_length = static_buffer->length;
+  fill_message_info(message_info, static_buffer->timestamp);
+
+  rmw_uxrce_put_static_input_buffer(static_buffer);
+
+  *taken = true;
+
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -165,13 +326,8 @@ rmw_take_loaned_message(
   bool * taken,
   rmw_subscription_allocation_t * allocation)
 {
-  (void)subscription;
-  (void)loaned_message;
-  (void)taken;
-  (void)allocation;
-
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  return rmw_take_loaned_message_with_info(
+    subscription, loaned_message, taken, NULL, allocation);
 }
 
 rmw_ret_t
@@ -182,14 +338,61 @@ rmw_take_loaned_message_with_info(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation)
 {
-  (void)subscription;
-  (void)loaned_message;
-  (void)taken;
-  (void)message_info;
   (void)allocation;
 
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(loaned_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
+
+  *taken = false;
+
+  if (!is_uxrce_rmw_identifier_valid(subscription->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("Wrong implementation");
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION;
+  }
+
+  if (!subscription->can_loan_messages) {
+    RMW_SET_ERROR_MSG("subscription does not lend messages");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
+
+  if (RMW_UXRCE_ZERO_COPY_PENDING == custom_subscription->zero_copy_state) {
+    RMW_SET_ERROR_MSG("Zero-copy sample pending, take into the registered destination.");
+    return RMW_RET_ERROR;
+  }
+
+  rmw_uxrce_static_input_buffer_t * static_buffer =
+    rmw_uxrce_input_queue_pop(&custom_subscription->input_queue);
+  if (static_buffer == NULL) {
+    return RMW_RET_ERROR;
+  }
+
+  if (NULL == static_buffer->loan) {
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+    RMW_SET_ERROR_MSG("Sample received without room for a loan.");
+    return RMW_RET_ERROR;
+  }
+
+  // The message is deserialized next to its payload and the buffer stays lent until returned.
+  // Arena memory is not initialized: zeroed, sequence members have no room and fail to
+  // deserialize instead of following garbage pointers
+  memset(static_buffer->loan, 0, custom_subscription->loan_size);
+  if (!deserialize_static_buffer(
+      custom_subscription, static_buffer, static_buffer->loan, message_info))
+  {
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+    RMW_SET_ERROR_MSG("Typesupport desserialize error.");
+    return RMW_RET_ERROR;
+  }
+
+  rmw_uxrce_subscription_push_loan(custom_subscription, static_buffer);
+
+  *loaned_message = static_buffer->loan;
+  *taken = true;
+
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -197,11 +400,31 @@ rmw_return_loaned_message_from_subscription(
   const rmw_subscription_t * subscription,
   void * loaned_message)
 {
-  (void)subscription;
-  (void)loaned_message;
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(loaned_message, RMW_RET_INVALID_ARGUMENT);
 
-  RMW_SET_ERROR_MSG("function not implemented");
-  return RMW_RET_UNSUPPORTED;
+  if (!is_uxrce_rmw_identifier_valid(subscription->implementation_identifier)) {
+    RMW_SET_ERROR_MSG("Wrong implementation");
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION;
+  }
+
+  if (!subscription->can_loan_messages) {
+    RMW_SET_ERROR_MSG("subscription does not lend messages");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscription->data;
+
+  rmw_uxrce_static_input_buffer_t * static_buffer =
+    rmw_uxrce_subscription_pop_loan(custom_subscription, loaned_message);
+  if (static_buffer == NULL) {
+    RMW_SET_ERROR_MSG("message was not loaned by this subscription");
+    return RMW_RET_ERROR;
+  }
+
+  rmw_uxrce_put_static_input_buffer(static_buffer);
+
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -14,12 +14,129 @@
 
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 
 #include <rmw/rmw.h>
 #include <rmw/error_handling.h>
 
 #include "./utils.h"
 
+// Maximum time a session is run while others are waiting their turn
+#define RMW_UXRCE_WAIT_SLICE_MS 10
+
+static bool
+check_guard_conditions(
+  rmw_guard_conditions_t * guard_conditions)
+{
+  if (guard_conditions) {
+    for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
+      bool * hasTriggered = (bool *)guard_conditions->guard_conditions[i];
+      if (*hasTriggered) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+static bool
+check_ready(
+  rmw_uxrce_wait_set_t * custom_wait_set,
+  rmw_subscriptions_t * subscriptions,
+  rmw_guard_conditions_t * guard_conditions,
+  rmw_services_t * services,
+  rmw_clients_t * clients)
+{
+  // Registered entities flag themselves in the wait set bitmap as samples land
+  if (custom_wait_set != NULL) {
+    return rmw_uxrce_wait_set_is_ready(custom_wait_set) ||
+           check_guard_conditions(guard_conditions);
+  }
+
+  if (services) {
+    for (size_t i = 0; i < services->service_count; ++i) {
+      rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)services->services[i];
+      if (rmw_uxrce_input_queue_has_data(&custom_service->input_queue)) {
+        return true;
+      }
+    }
+  }
+
+  if (clients) {
+    for (size_t i = 0; i < clients->client_count; ++i) {
+      rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)clients->clients[i];
+      if (rmw_uxrce_input_queue_has_data(&custom_client->input_queue)) {
+        return true;
+      }
+    }
+  }
+
+  if (subscriptions) {
+    for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
+      rmw_uxrce_subscription_t * custom_subscription =
+        (rmw_uxrce_subscription_t *)subscriptions->subscribers[i];
+      if (rmw_uxrce_input_queue_has_data(&custom_subscription->input_queue) ||
+        RMW_UXRCE_ZERO_COPY_PENDING == custom_subscription->zero_copy_state)
+      {
+        return true;
+      }
+    }
+  }
+
+  return check_guard_conditions(guard_conditions);
+}
+
+static bool
+mark_ready_entities(
+  rmw_uxrce_wait_set_t * custom_wait_set,
+  rmw_subscriptions_t * subscriptions,
+  rmw_services_t * services,
+  rmw_clients_t * clients)
+{
+  if (subscriptions) {
+    memset(subscriptions->subscribers, 0, subscriptions->subscriber_count * sizeof(void *));
+  }
+  if (services) {
+    memset(services->services, 0, services->service_count * sizeof(void *));
+  }
+  if (clients) {
+    memset(clients->clients, 0, clients->client_count * sizeof(void *));
+  }
+
+  size_t subscription_end = custom_wait_set->subscription_count;
+  size_t service_end = subscription_end + custom_wait_set->service_count;
+  size_t words = RMW_UXRCE_WAIT_SET_READY_WORDS(service_end + custom_wait_set->client_count);
+  bool any_ready = false;
+
+  UXR_LOCK(&static_buffer_memory.mutex);
+
+  // Only entities with their bit set are visited
+  for (size_t i = 0; i < words; i++) {
+    size_t index = i * 32;
+    uint32_t word = RMW_UXRCE_READY_WORD_LOAD(custom_wait_set->ready[i]);
+    for (; word != 0; word >>= 1, index++) {
+      if (!(word & 1u)) {
+        continue;
+      }
+
+      void * entity = custom_wait_set->entities[index];
+      if (index < subscription_end) {
+        subscriptions->subscribers[index] = entity;
+      } else if (index < service_end) {
+        services->services[index - subscription_end] = entity;
+      } else {
+        clients->clients[index - service_end] = entity;
+      }
+      any_ready = true;
+    }
+  }
+
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return any_ready;
+}
+
 rmw_ret_t
 rmw_wait(
   rmw_subscriptions_t * subscriptions,
@@ -30,10 +147,16 @@ rmw_wait(
   rmw_wait_set_t * wait_set,
   const rmw_time_t * wait_timeout)
 {
-  (void)services;
-  (void)clients;
   (void)events;
-  (void)wait_set;
+
+  // Wait sets keep their entities registered between calls, so readiness is read from a bitmap
+  rmw_uxrce_wait_set_t * custom_wait_set = NULL;
+  if (wait_set != NULL && wait_set->data != NULL) {
+    custom_wait_set = (rmw_uxrce_wait_set_t *)wait_set->data;
+    if (!rmw_uxrce_wait_set_register(custom_wait_set, subscriptions, services, clients)) {
+      custom_wait_set = NULL;
+    }
+  }
 
   // Check if timeout
   uint64_t timeout;
@@ -63,33 +186,62 @@ rmw_wait(
     timeout = (uint64_t)UXR_TIMEOUT_INF;
   }
 
-  // Run every XRCE session
+  // Data already received or guard conditions already triggered do not need a session run
+  if (!check_ready(custom_wait_set, subscriptions, guard_conditions, services, clients)) {
+    uint8_t available_contexts = 0;
+    rmw_uxrce_mempool_cursor_t cursor;
+    rmw_uxrce_mempool_item_t * item = first_memory(&session_memory, &cursor);
+    while (item != NULL) {
+      item = next_memory(&session_memory, &cursor);
+      available_contexts++;
+    }
 
-  uint8_t available_contexts = 0;
-  rmw_uxrce_mempool_item_t * item = NULL;
+    // Sessions are polled round-robin in slices, so none of them starves the others
+    // and guard conditions triggered meanwhile are noticed
+    bool use_slices = available_contexts > 1 ||
+      (guard_conditions != NULL && guard_conditions->guard_condition_count > 0);
+    bool infinite = timeout == (uint64_t)UXR_TIMEOUT_INF;
+    int64_t deadline = uxr_millis() + (int64_t)timeout;
 
-  item = session_memory.allocateditems;
-  while (item != NULL) {
-    item = item->next;
-    available_contexts++;
-  }
+    item = first_memory(&session_memory, &cursor);
+    while (item != NULL) {
+      int64_t remaining = infinite ? INT_MAX : deadline - uxr_millis();
+      if (remaining < 0) {
+        remaining = 0;
+      }
+
+      int slice = (int)remaining;
+      if (use_slices && slice > RMW_UXRCE_WAIT_SLICE_MS) {
+        slice = RMW_UXRCE_WAIT_SLICE_MS;
+      }
+
+      rmw_context_impl_t * custom_context = (rmw_context_impl_t *)item->data;
+      uxr_run_session_until_data(&custom_context->session, slice);
 
-  uint64_t per_session_timeout = (uint64_t)((float)timeout / (float)available_contexts);
-  item = session_memory.allocateditems;
-  while (item != NULL) {
-    rmw_context_impl_t * custom_context = (rmw_context_impl_t *)item->data;
-    uxr_run_session_until_data(&custom_context->session, per_session_timeout);
-    item = item->next;
+      if (check_ready(
+          custom_wait_set, subscriptions, guard_conditions, services,
+          clients) || (!infinite && remaining == 0))
+      {
+        break;
+      }
+
+      rmw_uxrce_mempool_item_t * next = next_memory(&session_memory, &cursor);
+      item = (next != NULL) ? next : first_memory(&session_memory, &cursor);
+    }
   }
 
   bool buffered_status = false;
 
+  if (custom_wait_set != NULL) {
+    buffered_status = mark_ready_entities(custom_wait_set, subscriptions, services, clients);
+  }
+
   // Check services
-  if (services) {
+  if (custom_wait_set == NULL && services) {
     for (size_t i = 0; i < services->service_count; ++i) {
       rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)services->services[i];
 
-      if (NULL == rmw_uxrce_find_static_input_buffer_by_owner((void *) custom_service)) {
+      if (!rmw_uxrce_input_queue_has_data(&custom_service->input_queue)) {
         services->services[i] = NULL;
       } else {
         buffered_status = true;
@@ -98,11 +250,11 @@ rmw_wait(
   }
 
   // Check clients
-  if (clients) {
+  if (custom_wait_set == NULL && clients) {
     for (size_t i = 0; i < clients->client_count; ++i) {
       rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)clients->clients[i];
 
-      if (NULL == rmw_uxrce_find_static_input_buffer_by_owner((void *) custom_client)) {
+      if (!rmw_uxrce_input_queue_has_data(&custom_client->input_queue)) {
         clients->clients[i] = NULL;
       } else {
         buffered_status = true;
@@ -111,12 +263,14 @@ rmw_wait(
   }
 
   // Check subscriptions
-  if (subscriptions) {
+  if (custom_wait_set == NULL && subscriptions) {
     for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
       rmw_uxrce_subscription_t * custom_subscription =
         (rmw_uxrce_subscription_t *)subscriptions->subscribers[i];
 
-      if (NULL == rmw_uxrce_find_static_input_buffer_by_owner((void *) custom_subscription)) {
+      if (!rmw_uxrce_input_queue_has_data(&custom_subscription->input_queue) &&
+        RMW_UXRCE_ZERO_COPY_PENDING != custom_subscription->zero_copy_state)
+      {
         subscriptions->subscribers[i] = NULL;
       } else {
         buffered_status = true;
@@ -24,10 +24,32 @@ rmw_create_wait_set(
   size_t max_conditions)
 {
   (void)context;
-  (void)max_conditions;
+
+  size_t capacity = (max_conditions > 0) ? max_conditions : RMW_UXRCE_WAIT_SET_DEFAULT_ENTITIES;
 
   rmw_wait_set_t * rmw_wait_set = (rmw_wait_set_t *)rmw_allocate(
     sizeof(rmw_wait_set_t));
+  if (rmw_wait_set == NULL) {
+    RMW_SET_ERROR_MSG("failed to allocate wait set");
+    return NULL;
+  }
+
+  // Registration array and readiness bitmap are allocated along with the wait set
+  rmw_uxrce_wait_set_t * custom_wait_set = (rmw_uxrce_wait_set_t *)rmw_allocate(
+    sizeof(rmw_uxrce_wait_set_t) + capacity * sizeof(void *) +
+    RMW_UXRCE_WAIT_SET_READY_WORDS(capacity) * sizeof(uint32_t));
+  if (custom_wait_set == NULL) {
+    RMW_SET_ERROR_MSG("failed to allocate wait set");
+    rmw_free(rmw_wait_set);
+    return NULL;
+  }
+  void ** entities = (void **)(void *)(custom_wait_set + 1);
+  uint32_t * ready = (uint32_t *)(void *)(entities + capacity);
+  rmw_uxrce_wait_set_init(custom_wait_set, entities, ready, capacity);
+
+  rmw_wait_set->implementation_identifier = rmw_get_implementation_identifier();
+  rmw_wait_set->guard_conditions = NULL;
+  rmw_wait_set->data = custom_wait_set;
 
   return rmw_wait_set;
 }
@@ -36,6 +58,17 @@ rmw_ret_t
 rmw_destroy_wait_set(
   rmw_wait_set_t * wait_set)
 {
+  if (wait_set == NULL) {
+    RMW_SET_ERROR_MSG("wait set handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  rmw_uxrce_wait_set_t * custom_wait_set = (rmw_uxrce_wait_set_t *)wait_set->data;
+  if (custom_wait_set != NULL) {
+    // Registered entities must stop flagging a bitmap that is about to go away
+    rmw_uxrce_wait_set_unregister(custom_wait_set);
+    rmw_free(custom_wait_set);
+  }
   rmw_free(wait_set);
 
   return RMW_RET_OK;
@@ -14,6 +14,8 @@
 
 #include <types.h>
 
+#include <string.h>
+
 #ifdef HAVE_C_TYPESUPPORT
 #include <rosidl_typesupport_microxrcedds_c/identifier.h>
 #endif /* ifdef HAVE_C_TYPESUPPORT */
@@ -24,7 +26,9 @@
 #include <rmw/allocators.h>
 #include <rmw/error_handling.h>
 
+#include <uxr/client/core/session/stream/seq_num.h>
 #include <uxr/client/profile/multithread/multithread.h>
+#include <uxr/client/util/time.h>
 
 #include "./utils.h"
 #include "./memory.h"
@@ -35,28 +39,42 @@
 char rmw_uxrce_entity_naming_buffer[RMW_UXRCE_ENTITY_NAMING_BUFFER_LENGTH];
 
 rmw_uxrce_mempool_t session_memory;
+rmw_uxrce_mempool_t node_memory;
+rmw_uxrce_mempool_t publisher_memory;
+rmw_uxrce_mempool_t subscription_memory;
+rmw_uxrce_mempool_t service_memory;
+rmw_uxrce_mempool_t client_memory;
+rmw_uxrce_mempool_t topics_memory;
+rmw_uxrce_arena_t static_buffer_memory;
+
+#ifdef RMW_UXRCE_STATIC_MEMORY_POOLS
 rmw_context_impl_t custom_sessions[RMW_UXRCE_MAX_SESSIONS];
+uint32_t custom_sessions_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_SESSIONS)];
 
-rmw_uxrce_mempool_t node_memory;
 rmw_uxrce_node_t custom_nodes[RMW_UXRCE_MAX_NODES];
+uint32_t custom_nodes_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_NODES)];
 
-rmw_uxrce_mempool_t publisher_memory;
 rmw_uxrce_publisher_t custom_publishers[RMW_UXRCE_MAX_PUBLISHERS + RMW_UXRCE_MAX_NODES];
+uint32_t custom_publishers_occupancy[
+  RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_PUBLISHERS + RMW_UXRCE_MAX_NODES)];
 
-rmw_uxrce_mempool_t subscription_memory;
 rmw_uxrce_subscription_t custom_subscriptions[RMW_UXRCE_MAX_SUBSCRIPTIONS];
+uint32_t custom_subscriptions_occupancy[
+  RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_SUBSCRIPTIONS)];
 
-rmw_uxrce_mempool_t service_memory;
 rmw_uxrce_service_t custom_services[RMW_UXRCE_MAX_SERVICES];
+uint32_t custom_services_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_SERVICES)];
 
-rmw_uxrce_mempool_t client_memory;
 rmw_uxrce_client_t custom_clients[RMW_UXRCE_MAX_CLIENTS];
+uint32_t custom_clients_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_CLIENTS)];
 
-rmw_uxrce_mempool_t topics_memory;
 rmw_uxrce_topic_t custom_topics[RMW_UXRCE_MAX_TOPICS_INTERNAL];
+uint32_t custom_topics_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_TOPICS_INTERNAL)];
+
+rmw_uxrce_arena_unit_t custom_static_buffers[RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS];
+#endif  // RMW_UXRCE_STATIC_MEMORY_POOLS
 
-rmw_uxrce_mempool_t static_buffer_memory;
-rmw_uxrce_static_input_buffer_t custom_static_buffers[RMW_UXRCE_MAX_HISTORY];
+rmw_uxrce_type_name_table_t type_name_table;
 
 // Memory init functions
 
@@ -64,22 +82,11 @@ rmw_uxrce_static_input_buffer_t custom_static_buffers[RMW_UXRCE_MAX_HISTORY];
   void rmw_uxrce_init_ ## X ## _memory( \
     rmw_uxrce_mempool_t * memory, \
     rmw_uxrce_ ## X ## _t * array, \
+    uint32_t * occupancy, \
     size_t size) \
   { \
-    if (size > 0 && !memory->is_initialized) { \
-      UXR_INIT_LOCK(&memory->mutex); \
-      memory->is_initialized = true; \
-      memory->element_size = sizeof(*array); \
-      memory->allocateditems = NULL; \
-      memory->freeitems = NULL; \
-      memory->is_dynamic_allowed = true; \
- \
-      for (size_t i = 0; i < size; i++) { \
-        put_memory(memory, &array[i].mem); \
-        array[i].mem.data = (void *)&array[i]; \
-        array[i].mem.is_dynamic_memory = false; \
-      } \
-    } \
+    init_memory( \
+      memory, array, sizeof(*array), offsetof(rmw_uxrce_ ## X ## _t, mem), occupancy, size); \
   }
 
 
@@ -90,7 +97,82 @@ RMW_INIT_MEMORY(subscription)
 RMW_INIT_MEMORY(node)
 RMW_INIT_MEMORY(session)
 RMW_INIT_MEMORY(topic)
-RMW_INIT_MEMORY(static_input_buffer)
+
+void rmw_uxrce_init_static_input_buffer_memory(
+  rmw_uxrce_arena_t * memory,
+  rmw_uxrce_arena_unit_t * units,
+  size_t size)
+{
+  init_arena_memory(memory, units, size);
+}
+
+void rmw_uxrce_init_type_name_table(
+  rmw_uxrce_type_name_table_t * table)
+{
+  // Names stay valid across contexts, type supports do not move
+  if (!table->is_initialized) {
+    UXR_INIT_LOCK(&table->mutex);
+    table->is_initialized = true;
+    table->count = 0;
+  }
+}
+
+// Runtime sized pools
+
+#define RMW_UXRCE_ARENA_ALIGNED(bytes) \
+  (RMW_UXRCE_ARENA_UNITS(bytes) * sizeof(rmw_uxrce_arena_unit_t))
+#define RMW_UXRCE_POOL_ARENA_SIZE(type, count) \
+  (RMW_UXRCE_ARENA_ALIGNED(sizeof(type) * (count)) + \
+  RMW_UXRCE_ARENA_ALIGNED(RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(count) * sizeof(uint32_t)))
+
+#define RMW_CARVE_MEMORY(X, memory, count) \
+  { \
+    rmw_uxrce_ ## X ## _t * array = (rmw_uxrce_ ## X ## _t *)cursor; \
+    cursor += RMW_UXRCE_ARENA_ALIGNED(sizeof(*array) * (count)); \
+    uint32_t * occupancy = (uint32_t *)cursor; \
+    cursor += RMW_UXRCE_ARENA_ALIGNED( \
+      RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(count) * sizeof(uint32_t)); \
+    rmw_uxrce_init_ ## X ## _memory(memory, array, occupancy, count); \
+  }
+
+static size_t arena_topics(
+  const rmw_uros_memory_arena_counts_t * counts)
+{
+  return (counts->topics > 0) ? counts->topics : counts->publishers + counts->subscriptions;
+}
+
+size_t rmw_uxrce_memory_arena_size(
+  const rmw_uros_memory_arena_counts_t * counts)
+{
+  return RMW_UXRCE_POOL_ARENA_SIZE(rmw_uxrce_session_t, counts->sessions) +
+         RMW_UXRCE_POOL_ARENA_SIZE(rmw_uxrce_node_t, counts->nodes) +
+         RMW_UXRCE_POOL_ARENA_SIZE(rmw_uxrce_publisher_t, counts->publishers) +
+         RMW_UXRCE_POOL_ARENA_SIZE(rmw_uxrce_subscription_t, counts->subscriptions) +
+         RMW_UXRCE_POOL_ARENA_SIZE(rmw_uxrce_service_t, counts->services) +
+         RMW_UXRCE_POOL_ARENA_SIZE(rmw_uxrce_client_t, counts->clients) +
+         RMW_UXRCE_POOL_ARENA_SIZE(rmw_uxrce_topic_t, arena_topics(counts)) +
+         RMW_UXRCE_INPUT_BUFFER_ARENA_UNITS(counts->history) * sizeof(rmw_uxrce_arena_unit_t);
+}
+
+void rmw_uxrce_init_memory_arena(
+  void * buffer,
+  const rmw_uros_memory_arena_counts_t * counts)
+{
+  // Pools already set up by a previous context are kept as they are
+  uint8_t * cursor = (uint8_t *)buffer;
+
+  RMW_CARVE_MEMORY(session, &session_memory, counts->sessions)
+  RMW_CARVE_MEMORY(node, &node_memory, counts->nodes)
+  RMW_CARVE_MEMORY(publisher, &publisher_memory, counts->publishers)
+  RMW_CARVE_MEMORY(subscription, &subscription_memory, counts->subscriptions)
+  RMW_CARVE_MEMORY(service, &service_memory, counts->services)
+  RMW_CARVE_MEMORY(client, &client_memory, counts->clients)
+  RMW_CARVE_MEMORY(topic, &topics_memory, arena_topics(counts))
+
+  rmw_uxrce_init_static_input_buffer_memory(
+    &static_buffer_memory, (rmw_uxrce_arena_unit_t *)cursor,
+    RMW_UXRCE_INPUT_BUFFER_ARENA_UNITS(counts->history));
+}
 
 // Memory management functions
 
@@ -172,6 +254,8 @@ void rmw_uxrce_fini_subscription_memory(
     rmw_uxrce_subscription_t * custom_subscription = (rmw_uxrce_subscription_t *)subscriber->data;
 
     custom_subscription->rmw_handle = NULL;
+    rmw_uxrce_input_queue_fini(&custom_subscription->input_queue);
+    rmw_uxrce_subscription_flush_loans(custom_subscription);
 
     put_memory(&subscription_memory, &custom_subscription->mem);
     subscriber->data = NULL;
@@ -195,6 +279,7 @@ void rmw_uxrce_fini_service_memory(
   if (service->data) {
     rmw_uxrce_service_t * custom_service = (rmw_uxrce_service_t *)service->data;
     custom_service->rmw_handle = NULL;
+    rmw_uxrce_input_queue_fini(&custom_service->input_queue);
 
     put_memory(&service_memory, &custom_service->mem);
     service->data = NULL;
@@ -218,6 +303,7 @@ void rmw_uxrce_fini_client_memory(
   if (client->data) {
     rmw_uxrce_client_t * custom_client = (rmw_uxrce_client_t *)client->data;
     custom_client->rmw_handle = NULL;
+    rmw_uxrce_input_queue_fini(&custom_client->input_queue);
 
     put_memory(&client_memory, &custom_client->mem);
     client->data = NULL;
@@ -232,17 +318,870 @@ void rmw_uxrce_fini_topic_memory(
   topic->owner_node = NULL;
 }
 
-rmw_uxrce_mempool_item_t * rmw_uxrce_find_static_input_buffer_by_owner(
-  void * owner)
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_get_static_input_buffer(
+  size_t length)
+{
+  rmw_uxrce_static_input_buffer_t * static_buffer =
+    (rmw_uxrce_static_input_buffer_t *)get_arena_memory(
+    &static_buffer_memory, sizeof(rmw_uxrce_static_input_buffer_t) + length);
+
+  if (static_buffer != NULL) {
+    static_buffer->buffer = (uint8_t *)(static_buffer + 1);
+    static_buffer->length = length;
+    static_buffer->owner = NULL;
+    static_buffer->loan = NULL;
+    static_buffer->queue_next = NULL;
+  }
+
+  return static_buffer;
+}
+
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_get_loanable_static_input_buffer(
+  size_t length,
+  size_t loan_size)
+{
+  // The loaned message follows the payload, aligned as any arena block
+  size_t loan_offset =
+    RMW_UXRCE_ARENA_UNITS(sizeof(rmw_uxrce_static_input_buffer_t) + length) *
+    sizeof(rmw_uxrce_arena_unit_t);
+
+  rmw_uxrce_static_input_buffer_t * static_buffer =
+    rmw_uxrce_get_static_input_buffer(
+    loan_offset - sizeof(rmw_uxrce_static_input_buffer_t) + loan_size);
+
+  if (static_buffer != NULL) {
+    static_buffer->length = length;
+    static_buffer->loan = (uint8_t *)static_buffer + loan_offset;
+  }
+
+  return static_buffer;
+}
+
+void rmw_uxrce_put_static_input_buffer(
+  rmw_uxrce_static_input_buffer_t * static_buffer)
+{
+  put_arena_memory(&static_buffer_memory, static_buffer);
+}
+
+void rmw_uxrce_put_static_input_buffer_list(
+  rmw_uxrce_static_input_buffer_t * static_buffer)
+{
+#ifndef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  UXR_LOCK(&static_buffer_memory.mutex);
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  while (static_buffer != NULL) {
+    rmw_uxrce_static_input_buffer_t * next = static_buffer->queue_next;
+    put_arena_memory(&static_buffer_memory, static_buffer);
+    static_buffer = next;
+  }
+#ifndef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+}
+
+// Input queue functions
+
+// Bumped whenever a readiness bit may have changed hands, so wait sets register again
+static uint32_t wait_set_epoch = 0;
+
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+// Single producer (session) pushes at tail, single consumer (take) pops at head.
+// KEEP_LAST eviction pops from the session thread too, so head is claimed with a CAS.
+// A pop reads the slots from head on and only owns them once its CAS moves head past them:
+// exactly one of two concurrent pops wins a position, and the loser drops what it read, as the
+// slots may be reused by the producer once head has moved. The sample in a slot is thus handed
+// to a single popper, and only that one gives its block back to the arena.
+// Positions wrap at a multiple of the ring size, so slots stay in sequence, and far enough
+// for head not to come back to the value a losing pop read.
+#define INPUT_QUEUE_LOCK()
+#define INPUT_QUEUE_UNLOCK()
+
+static size_t input_queue_advance(
+  const rmw_uxrce_input_queue_t * queue,
+  size_t position,
+  size_t count)
+{
+  return (position + count) % queue->positions;
+}
+
+static size_t input_queue_distance(
+  const rmw_uxrce_input_queue_t * queue,
+  size_t head,
+  size_t tail)
+{
+  return (tail >= head) ? tail - head : tail + (queue->positions - head);
+}
+
+static bool input_queue_carve_ring(
+  rmw_uxrce_input_queue_t * queue)
+{
+  // KEEP_LAST readers never hold more than their depth
+  size_t capacity = RMW_UXRCE_INPUT_QUEUE_SIZE;
+  if (queue->depth > 0 && queue->depth < capacity) {
+    capacity = queue->depth;
+  }
+
+  // The session thread is the only one taking arena blocks
+  rmw_uxrce_static_input_buffer_t ** ring =
+    (rmw_uxrce_static_input_buffer_t **)get_arena_memory(
+    &static_buffer_memory, capacity * sizeof(rmw_uxrce_static_input_buffer_t *));
+  if (NULL == ring) {
+    return false;
+  }
+
+  queue->capacity = capacity;
+  queue->positions = (SIZE_MAX / capacity - 1) * capacity;
+  __atomic_store_n(&queue->ring, ring, __ATOMIC_RELEASE);
+
+  return true;
+}
+#else
+#define INPUT_QUEUE_LOCK() UXR_LOCK(&static_buffer_memory.mutex)
+#define INPUT_QUEUE_UNLOCK() UXR_UNLOCK(&static_buffer_memory.mutex)
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+
+static void input_queue_link(
+  rmw_uxrce_input_queue_t * queue,
+  uint32_t * word,
+  uint32_t mask)
+{
+  // Links change under the mutex, but the session thread may follow them without it
+  queue->ready.mask = mask;
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  __atomic_store_n(&queue->ready.word, word, __ATOMIC_RELEASE);
+#else
+  queue->ready.word = word;
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+}
+
+void rmw_uxrce_input_queue_init(
+  rmw_uxrce_input_queue_t * queue)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  queue->ring = NULL;
+  queue->capacity = 0;
+  queue->positions = 0;
+  queue->head = 0;
+  queue->tail = 0;
+#else
+  queue->head = NULL;
+  queue->tail = NULL;
+  queue->count = 0;
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  queue->depth = 0;
+  input_queue_link(queue, NULL, 0);
+  wait_set_epoch++;
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+}
+
+void rmw_uxrce_input_queue_detach(
+  rmw_uxrce_input_queue_t * queue)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+  rmw_uxrce_input_queue_set_ready(queue, false);
+  input_queue_link(queue, NULL, 0);
+  wait_set_epoch++;
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+}
+
+void rmw_uxrce_input_queue_set_ready(
+  rmw_uxrce_input_queue_t * queue,
+  bool ready)
+{
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  // Other entities flip their bits of the same word concurrently
+  uint32_t * word = __atomic_load_n(&queue->ready.word, __ATOMIC_ACQUIRE);
+  if (word != NULL) {
+    if (ready) {
+      __atomic_fetch_or(word, queue->ready.mask, __ATOMIC_SEQ_CST);
+    } else {
+      __atomic_fetch_and(word, ~queue->ready.mask, __ATOMIC_SEQ_CST);
+    }
+  }
+#else
+  UXR_LOCK(&static_buffer_memory.mutex);
+  if (queue->ready.word != NULL) {
+    if (ready) {
+      *queue->ready.word |= queue->ready.mask;
+    } else {
+      *queue->ready.word &= ~queue->ready.mask;
+    }
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+}
+
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+bool rmw_uxrce_input_queue_push(
+  rmw_uxrce_input_queue_t * queue,
+  rmw_uxrce_static_input_buffer_t * static_buffer)
+{
+  if (NULL == queue->ring && !input_queue_carve_ring(queue)) {
+    return false;
+  }
+
+  // Only this thread moves tail, the slot is free until tail is published
+  size_t tail = queue->tail;
+  if (input_queue_distance(queue, __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE), tail) >=
+    queue->capacity)
+  {
+    return false;
+  }
+
+  static_buffer->queue_next = NULL;
+  __atomic_store_n(&queue->ring[tail % queue->capacity], static_buffer, __ATOMIC_RELAXED);
+  __atomic_store_n(&queue->tail, input_queue_advance(queue, tail, 1), __ATOMIC_RELEASE);
+  rmw_uxrce_input_queue_set_ready(queue, true);
+
+  return true;
+}
+
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_input_queue_pop_batch(
+  rmw_uxrce_input_queue_t * queue,
+  size_t max_count,
+  size_t * count)
+{
+  rmw_uxrce_static_input_buffer_t * taken[RMW_UXRCE_INPUT_QUEUE_SIZE];
+  rmw_uxrce_static_input_buffer_t ** ring = __atomic_load_n(&queue->ring, __ATOMIC_ACQUIRE);
+  size_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+
+  *count = 0;
+  if (NULL == ring) {
+    return NULL;
+  }
+
+  // Slots are read before claiming them, a failed claim means they may have been reused
+  do {
+    size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    *count = input_queue_distance(queue, head, tail);
+    if (*count > max_count) {
+      *count = max_count;
+    }
+    if (*count == 0) {
+      return NULL;
+    }
+    for (size_t i = 0; i < *count; i++) {
+      taken[i] = __atomic_load_n(
+        &ring[input_queue_advance(queue, head, i) % queue->capacity], __ATOMIC_RELAXED);
+    }
+  } while (!__atomic_compare_exchange_n(
+    &queue->head, &head, input_queue_advance(queue, head, *count), false,
+    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+  // Items stay linked oldest first
+  for (size_t i = 0; i < *count; i++) {
+    taken[i]->queue_next = (i + 1 < *count) ? taken[i + 1] : NULL;
+  }
+
+  // A sample pushed meanwhile sets the bit again, so it is checked after clearing
+  if (!rmw_uxrce_input_queue_has_data(queue)) {
+    rmw_uxrce_input_queue_set_ready(queue, false);
+    if (rmw_uxrce_input_queue_has_data(queue)) {
+      rmw_uxrce_input_queue_set_ready(queue, true);
+    }
+  }
+
+  return taken[0];
+}
+
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_input_queue_pop(
+  rmw_uxrce_input_queue_t * queue)
+{
+  size_t count;
+  return rmw_uxrce_input_queue_pop_batch(queue, 1, &count);
+}
+
+size_t rmw_uxrce_input_queue_count(
+  const rmw_uxrce_input_queue_t * queue)
+{
+  // The ring is published after the positions are set up
+  if (NULL == __atomic_load_n(&queue->ring, __ATOMIC_ACQUIRE)) {
+    return 0;
+  }
+
+  // Reading head first keeps it behind the tail read afterwards
+  size_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+  return input_queue_distance(queue, head, __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE));
+}
+
+bool rmw_uxrce_input_queue_has_data(
+  const rmw_uxrce_input_queue_t * queue)
+{
+  return rmw_uxrce_input_queue_count(queue) > 0;
+}
+#else
+bool rmw_uxrce_input_queue_push(
+  rmw_uxrce_input_queue_t * queue,
+  rmw_uxrce_static_input_buffer_t * static_buffer)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+
+  static_buffer->queue_next = NULL;
+  if (queue->tail != NULL) {
+    queue->tail->queue_next = static_buffer;
+  } else {
+    queue->head = static_buffer;
+  }
+  queue->tail = static_buffer;
+  queue->count++;
+  rmw_uxrce_input_queue_set_ready(queue, true);
+
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return true;
+}
+
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_input_queue_pop(
+  rmw_uxrce_input_queue_t * queue)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+
+  rmw_uxrce_static_input_buffer_t * static_buffer = queue->head;
+  if (static_buffer != NULL) {
+    queue->head = static_buffer->queue_next;
+    if (queue->head == NULL) {
+      queue->tail = NULL;
+    }
+    queue->count--;
+    static_buffer->queue_next = NULL;
+    rmw_uxrce_input_queue_set_ready(queue, queue->head != NULL);
+  }
+
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return static_buffer;
+}
+
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_input_queue_pop_batch(
+  rmw_uxrce_input_queue_t * queue,
+  size_t max_count,
+  size_t * count)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+
+  // Detach up to max_count items, they stay linked oldest first
+  rmw_uxrce_static_input_buffer_t * first = queue->head;
+  rmw_uxrce_static_input_buffer_t * last = NULL;
+  *count = 0;
+  while (*count < max_count && queue->head != NULL) {
+    last = queue->head;
+    queue->head = last->queue_next;
+    (*count)++;
+  }
+
+  if (last != NULL) {
+    last->queue_next = NULL;
+  } else {
+    first = NULL;
+  }
+  if (queue->head == NULL) {
+    queue->tail = NULL;
+  }
+  queue->count -= *count;
+  rmw_uxrce_input_queue_set_ready(queue, queue->head != NULL);
+
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return first;
+}
+
+size_t rmw_uxrce_input_queue_count(
+  const rmw_uxrce_input_queue_t * queue)
+{
+  return queue->count;
+}
+
+bool rmw_uxrce_input_queue_has_data(
+  const rmw_uxrce_input_queue_t * queue)
+{
+  return queue->head != NULL;
+}
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+
+void rmw_uxrce_input_queue_flush(
+  rmw_uxrce_input_queue_t * queue)
+{
+  rmw_uxrce_static_input_buffer_t * static_buffer;
+  while ((static_buffer = rmw_uxrce_input_queue_pop(queue)) != NULL) {
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+  }
+}
+
+void rmw_uxrce_input_queue_fini(
+  rmw_uxrce_input_queue_t * queue)
+{
+  rmw_uxrce_input_queue_detach(queue);
+  rmw_uxrce_input_queue_flush(queue);
+
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  if (NULL != queue->ring) {
+    put_arena_memory(&static_buffer_memory, queue->ring);
+    queue->ring = NULL;
+  }
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+}
+
+void rmw_uxrce_input_queue_set_depth(
+  rmw_uxrce_input_queue_t * queue,
+  size_t depth)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+  queue->depth = depth;
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+}
+
+void rmw_uxrce_input_queue_make_room(
+  rmw_uxrce_input_queue_t * queue)
+{
+  INPUT_QUEUE_LOCK();
+
+  size_t limit = queue->depth;
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  // The ring also bounds KEEP_LAST readers, KEEP_ALL ones drop samples that do not fit
+  if (limit > RMW_UXRCE_INPUT_QUEUE_SIZE) {
+    limit = RMW_UXRCE_INPUT_QUEUE_SIZE;
+  }
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+
+  while (limit > 0 && rmw_uxrce_input_queue_count(queue) >= limit) {
+    if (!rmw_uxrce_input_queue_evict(queue)) {
+      break;
+    }
+  }
+
+  INPUT_QUEUE_UNLOCK();
+}
+
+bool rmw_uxrce_input_queue_evict(
+  rmw_uxrce_input_queue_t * queue)
+{
+  // Only readers with a KEEP_LAST depth give up their own oldest sample
+  bool evicted = false;
+
+  INPUT_QUEUE_LOCK();
+  if (queue->depth > 0) {
+    rmw_uxrce_static_input_buffer_t * static_buffer = rmw_uxrce_input_queue_pop(queue);
+    if (static_buffer != NULL) {
+      rmw_uxrce_put_static_input_buffer(static_buffer);
+      evicted = true;
+    }
+  }
+  INPUT_QUEUE_UNLOCK();
+
+  return evicted;
+}
+
+// Publisher loan functions
+
+void * rmw_uxrce_publisher_get_loan(
+  rmw_uxrce_publisher_t * publisher)
+{
+  for (size_t i = 0; i < publisher->loan_count; i++) {
+    uint32_t mask = (uint32_t)1 << i;
+    if (!(publisher->loans_in_use & mask)) {
+      publisher->loans_in_use |= mask;
+      return &publisher->loan_pool[i * publisher->loan_size];
+    }
+  }
+
+  return NULL;
+}
+
+bool rmw_uxrce_publisher_put_loan(
+  rmw_uxrce_publisher_t * publisher,
+  void * loaned_message)
+{
+  uint8_t * message = (uint8_t *)loaned_message;
+  if (NULL == publisher->loan_pool || message < publisher->loan_pool ||
+    message >= &publisher->loan_pool[publisher->loan_count * publisher->loan_size])
+  {
+    return false;
+  }
+
+  size_t offset = (size_t)(message - publisher->loan_pool);
+  uint32_t mask = (uint32_t)1 << (offset / publisher->loan_size);
+  if (offset % publisher->loan_size != 0 || !(publisher->loans_in_use & mask)) {
+    return false;
+  }
+
+  publisher->loans_in_use &= ~mask;
+
+  return true;
+}
+
+// Publisher in-flight functions
+
+void rmw_uxrce_publisher_push_in_flight(
+  rmw_uxrce_publisher_t * publisher,
+  size_t bytes)
+{
+  publisher->in_flight_samples++;
+  publisher->in_flight_bytes += bytes;
+}
+
+void rmw_uxrce_publisher_purge_in_flight(
+  rmw_uxrce_publisher_t * publisher)
+{
+  // Acknowledgements are only known for the whole session, so the counters are cleared
+  // once every reliable output stream is confirmed. The session is polled without waiting
+  if (publisher->in_flight_samples > 0 &&
+    uxr_run_session_until_confirm_delivery(&publisher->owner_node->context->session, 0))
+  {
+    publisher->in_flight_samples = 0;
+    publisher->in_flight_bytes = 0;
+  }
+}
+
+// Priority class functions
+
+// A budget allows bursts of this length
+#define RMW_UXRCE_PRIORITY_BURST_MS 100
+
+void rmw_uxrce_init_priority_classes(
+  rmw_uxrce_priority_class_t * classes,
+  size_t size)
+{
+  for (size_t i = 0; i < size; i++) {
+    classes[i].budget = 0;
+    classes[i].tokens = 0;
+    classes[i].last_refill = uxr_millis();
+    classes[i].sent_bytes = 0;
+    classes[i].dropped_samples = 0;
+  }
+}
+
+bool rmw_uxrce_priority_class_admit(
+  rmw_uxrce_priority_class_t * priority_class,
+  size_t bytes)
+{
+  if (0 == priority_class->budget) {
+    priority_class->sent_bytes += bytes;
+    return true;
+  }
+
+  int64_t now = uxr_millis();
+  int64_t capacity = (int64_t)priority_class->budget * RMW_UXRCE_PRIORITY_BURST_MS / 1000;
+  int64_t refill = (now - priority_class->last_refill) * (int64_t)priority_class->budget / 1000;
+  if (refill > 0) {
+    priority_class->tokens += refill;
+    priority_class->last_refill = now;
+  }
+  if (priority_class->tokens > capacity) {
+    priority_class->tokens = capacity;
+  }
+
+  // Samples larger than the burst are let through on a full bucket, leaving it in debt
+  if (priority_class->tokens <= 0) {
+    return false;
+  }
+
+  priority_class->tokens -= (int64_t)bytes;
+  priority_class->sent_bytes += bytes;
+  return true;
+}
+
+// Subscription loan functions
+
+void rmw_uxrce_subscription_push_loan(
+  rmw_uxrce_subscription_t * subscription,
+  rmw_uxrce_static_input_buffer_t * static_buffer)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+  static_buffer->queue_next = subscription->loans;
+  subscription->loans = static_buffer;
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+}
+
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_subscription_pop_loan(
+  rmw_uxrce_subscription_t * subscription,
+  void * loaned_message)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+
+  rmw_uxrce_static_input_buffer_t ** link = &subscription->loans;
+  while (*link != NULL && (*link)->loan != loaned_message) {
+    link = &(*link)->queue_next;
+  }
+
+  rmw_uxrce_static_input_buffer_t * static_buffer = *link;
+  if (static_buffer != NULL) {
+    *link = static_buffer->queue_next;
+    static_buffer->queue_next = NULL;
+  }
+
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return static_buffer;
+}
+
+void rmw_uxrce_subscription_flush_loans(
+  rmw_uxrce_subscription_t * subscription)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+  rmw_uxrce_static_input_buffer_t * loans = subscription->loans;
+  subscription->loans = NULL;
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  rmw_uxrce_put_static_input_buffer_list(loans);
+}
+
+// Wait set functions
+
+void rmw_uxrce_wait_set_init(
+  rmw_uxrce_wait_set_t * wait_set,
+  void ** entities,
+  uint32_t * ready,
+  size_t capacity)
+{
+  wait_set->entities = entities;
+  wait_set->capacity = capacity;
+  wait_set->subscription_count = 0;
+  wait_set->service_count = 0;
+  wait_set->client_count = 0;
+  wait_set->registered = false;
+  wait_set->epoch = 0;
+  wait_set->ready = ready;
+  memset(ready, 0, RMW_UXRCE_WAIT_SET_READY_WORDS(capacity) * sizeof(uint32_t));
+}
+
+static void wait_set_detach_pool(
+  rmw_uxrce_wait_set_t * wait_set,
+  rmw_uxrce_mempool_t * memory,
+  size_t queue_offset)
+{
+  size_t words = RMW_UXRCE_WAIT_SET_READY_WORDS(wait_set->capacity);
+  uintptr_t first = (uintptr_t)wait_set->ready;
+  uintptr_t last = (uintptr_t)(wait_set->ready + words);
+
+  rmw_uxrce_mempool_cursor_t cursor;
+  for (rmw_uxrce_mempool_item_t * item = first_memory(memory, &cursor); item != NULL;
+    item = next_memory(memory, &cursor))
+  {
+    rmw_uxrce_input_queue_t * queue =
+      (rmw_uxrce_input_queue_t *)((uint8_t *)item->data + queue_offset);
+    uintptr_t word = (uintptr_t)queue->ready.word;
+    if (word >= first && word < last) {
+      input_queue_link(queue, NULL, 0);
+    }
+  }
+}
+
+static rmw_uxrce_input_queue_t * wait_set_entity_queue(
+  rmw_uxrce_wait_set_t * wait_set,
+  size_t index)
+{
+  void * entity = wait_set->entities[index];
+  if (index < wait_set->subscription_count) {
+    return &((rmw_uxrce_subscription_t *)entity)->input_queue;
+  }
+  if (index < wait_set->subscription_count + wait_set->service_count) {
+    return &((rmw_uxrce_service_t *)entity)->input_queue;
+  }
+  return &((rmw_uxrce_client_t *)entity)->input_queue;
+}
+
+static bool wait_set_matches(
+  rmw_uxrce_wait_set_t * wait_set,
+  void ** entities,
+  size_t count,
+  size_t offset)
+{
+  return 0 == count || 0 == memcmp(&wait_set->entities[offset], entities, count * sizeof(void *));
+}
+
+static void wait_set_add(
+  rmw_uxrce_wait_set_t * wait_set,
+  void ** entities,
+  size_t count,
+  size_t offset)
+{
+  for (size_t i = 0; i < count; i++) {
+    size_t index = offset + i;
+    wait_set->entities[index] = entities[i];
+
+    rmw_uxrce_input_queue_t * queue = wait_set_entity_queue(wait_set, index);
+    input_queue_link(queue, &wait_set->ready[index / 32], (uint32_t)1 << (index % 32));
+
+    bool ready = rmw_uxrce_input_queue_has_data(queue);
+    if (index < wait_set->subscription_count) {
+      ready |= RMW_UXRCE_ZERO_COPY_PENDING ==
+        ((rmw_uxrce_subscription_t *)entities[i])->zero_copy_state;
+    }
+    rmw_uxrce_input_queue_set_ready(queue, ready);
+  }
+}
+
+bool rmw_uxrce_wait_set_register(
+  rmw_uxrce_wait_set_t * wait_set,
+  rmw_subscriptions_t * subscriptions,
+  rmw_services_t * services,
+  rmw_clients_t * clients)
 {
-  rmw_uxrce_mempool_item_t * static_buffer_item = static_buffer_memory.allocateditems;
-  while (static_buffer_item != NULL) {
-    rmw_uxrce_static_input_buffer_t * data =
-      (rmw_uxrce_static_input_buffer_t *)static_buffer_item->data;
-    if (data->owner == owner) {
-      return static_buffer_item;
+  size_t subscription_count = (subscriptions) ? subscriptions->subscriber_count : 0;
+  size_t service_count = (services) ? services->service_count : 0;
+  size_t client_count = (clients) ? clients->client_count : 0;
+
+  if (subscription_count + service_count + client_count > wait_set->capacity) {
+    return false;
+  }
+
+  UXR_LOCK(&static_buffer_memory.mutex);
+
+  // Executors usually wait on the same entities over and over
+  bool registered = wait_set->registered &&
+    wait_set->epoch == wait_set_epoch &&
+    wait_set->subscription_count == subscription_count &&
+    wait_set->service_count == service_count &&
+    wait_set->client_count == client_count &&
+    wait_set_matches(
+    wait_set, (subscription_count) ? subscriptions->subscribers : NULL, subscription_count, 0) &&
+    wait_set_matches(
+    wait_set, (service_count) ? services->services : NULL, service_count, subscription_count) &&
+    wait_set_matches(
+    wait_set, (client_count) ? clients->clients : NULL, client_count,
+    subscription_count + service_count);
+
+  if (!registered) {
+    rmw_uxrce_wait_set_unregister(wait_set);
+
+    wait_set->subscription_count = subscription_count;
+    wait_set->service_count = service_count;
+    wait_set->client_count = client_count;
+
+    if (subscription_count) {
+      wait_set_add(wait_set, subscriptions->subscribers, subscription_count, 0);
     }
-    static_buffer_item = static_buffer_item->next;
+    if (service_count) {
+      wait_set_add(wait_set, services->services, service_count, subscription_count);
+    }
+    if (client_count) {
+      wait_set_add(wait_set, clients->clients, client_count, subscription_count + service_count);
+    }
+
+    // Entities taken from other wait sets have to be registered there again
+    wait_set->epoch = ++wait_set_epoch;
+    wait_set->registered = true;
+  }
+
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return true;
+}
+
+void rmw_uxrce_wait_set_unregister(
+  rmw_uxrce_wait_set_t * wait_set)
+{
+  UXR_LOCK(&static_buffer_memory.mutex);
+
+  // Registered entities may have been destroyed since, so only live pool elements are visited
+  if (wait_set->registered) {
+    wait_set_detach_pool(
+      wait_set, &subscription_memory, offsetof(rmw_uxrce_subscription_t, input_queue));
+    wait_set_detach_pool(wait_set, &service_memory, offsetof(rmw_uxrce_service_t, input_queue));
+    wait_set_detach_pool(wait_set, &client_memory, offsetof(rmw_uxrce_client_t, input_queue));
+  }
+
+  rmw_uxrce_wait_set_init(wait_set, wait_set->entities, wait_set->ready, wait_set->capacity);
+
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+}
+
+bool rmw_uxrce_wait_set_is_ready(
+  rmw_uxrce_wait_set_t * wait_set)
+{
+  size_t words = RMW_UXRCE_WAIT_SET_READY_WORDS(
+    wait_set->subscription_count + wait_set->service_count + wait_set->client_count);
+  uint32_t any = 0;
+
+  UXR_LOCK(&static_buffer_memory.mutex);
+  for (size_t i = 0; i < words; i++) {
+    any |= RMW_UXRCE_READY_WORD_LOAD(wait_set->ready[i]);
+  }
+  UXR_UNLOCK(&static_buffer_memory.mutex);
+
+  return any != 0;
+}
+
+// Entity table functions
+
+void rmw_uxrce_init_entity_table(
+  rmw_uxrce_entity_table_t * table,
+  rmw_uxrce_entity_table_entry_t * entries,
+  size_t size)
+{
+  table->entries = entries;
+  table->size = size;
+  table->overflow = 0;
+  memset(entries, 0, size * sizeof(rmw_uxrce_entity_table_entry_t));
+}
+
+static rmw_uxrce_entity_table_entry_t * entity_table_entry(
+  rmw_uxrce_entity_table_t * table,
+  uxrObjectId object_id)
+{
+  // Tables sized for no entities keep every entity in the overflow
+  if (0 == table->size) {
+    return NULL;
+  }
+  return &table->entries[object_id.id % table->size];
+}
+
+uxrObjectId rmw_uxrce_entity_table_next_id(
+  rmw_uxrce_entity_table_t * table,
+  uint16_t * id_counter,
+  uint8_t type)
+{
+  // Skip ids whose slot is taken, so that every live entity gets its own slot
+  uint16_t id = *id_counter;
+  for (size_t i = 0; i < table->size; i++) {
+    if (NULL == table->entries[id % table->size].entity) {
+      break;
+    }
+    id++;
+  }
+  *id_counter = id + 1;
+
+  return uxr_object_id(id, type);
+}
+
+void rmw_uxrce_entity_table_insert(
+  rmw_uxrce_entity_table_t * table,
+  uxrObjectId object_id,
+  void * entity)
+{
+  rmw_uxrce_entity_table_entry_t * entry = entity_table_entry(table, object_id);
+  if (NULL != entry && NULL == entry->entity) {
+    entry->object_id = object_id;
+    entry->entity = entity;
+  } else {
+    table->overflow++;
+  }
+}
+
+void rmw_uxrce_entity_table_remove(
+  rmw_uxrce_entity_table_t * table,
+  uxrObjectId object_id,
+  void * entity)
+{
+  rmw_uxrce_entity_table_entry_t * entry = entity_table_entry(table, object_id);
+  if (NULL != entry && entry->entity == entity) {
+    entry->entity = NULL;
+  } else if (table->overflow > 0) {
+    table->overflow--;
+  }
+}
+
+void * rmw_uxrce_entity_table_find(
+  rmw_uxrce_entity_table_t * table,
+  uxrObjectId object_id)
+{
+  rmw_uxrce_entity_table_entry_t * entry = entity_table_entry(table, object_id);
+  if (NULL != entry && NULL != entry->entity &&
+    entry->object_id.id == object_id.id &&
+    entry->object_id.type == object_id.type)
+  {
+    return entry->entity;
   }
   return NULL;
 }
@@ -36,6 +36,16 @@
 
 #include "./memory.h"
 
+#if RMW_UXRCE_RELIABLE_OUTPUT_STREAMS > UXR_CONFIG_MAX_OUTPUT_RELIABLE_STREAMS
+#error RMW_UXRCE_RELIABLE_OUTPUT_STREAMS exceeds UXR_CONFIG_MAX_OUTPUT_RELIABLE_STREAMS
+#endif  // RMW_UXRCE_RELIABLE_OUTPUT_STREAMS > UXR_CONFIG_MAX_OUTPUT_RELIABLE_STREAMS
+#if RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS > UXR_CONFIG_MAX_OUTPUT_BEST_EFFORT_STREAMS
+#error RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS exceeds UXR_CONFIG_MAX_OUTPUT_BEST_EFFORT_STREAMS
+#endif  // RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS > UXR_CONFIG_MAX_OUTPUT_BEST_EFFORT_STREAMS
+#if RMW_UXRCE_STREAM_HISTORY_OUTPUT_PER_STREAM < 1
+#error RMW_UXRCE_STREAM_HISTORY_OUTPUT is smaller than RMW_UXRCE_RELIABLE_OUTPUT_STREAMS
+#endif  // RMW_UXRCE_STREAM_HISTORY_OUTPUT_PER_STREAM < 1
+
 // RMW specific definitions
 #ifdef RMW_UXRCE_GRAPH
 typedef struct rmw_graph_info_t
@@ -56,6 +66,79 @@ typedef struct rmw_graph_info_t
 } rmw_graph_info_t;
 #endif  // RMW_UXRCE_GRAPH
 
+// Direct-indexed lookup of input entities by XRCE object id
+typedef struct rmw_uxrce_entity_table_entry_t
+{
+  uxrObjectId object_id;
+  void * entity;
+} rmw_uxrce_entity_table_entry_t;
+
+typedef struct rmw_uxrce_entity_table_t
+{
+  rmw_uxrce_entity_table_entry_t * entries;
+  size_t size;
+
+  // Number of entities that could not be placed in the table
+  size_t overflow;
+} rmw_uxrce_entity_table_t;
+
+// Readiness bit of an entity inside the bitmap of the wait set it is registered in
+typedef struct rmw_uxrce_ready_flag_t
+{
+  uint32_t * word;
+  uint32_t mask;
+} rmw_uxrce_ready_flag_t;
+
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+// Readiness bits are flipped by the session thread without taking the mutex
+#define RMW_UXRCE_READY_WORD_LOAD(word) __atomic_load_n(&(word), __ATOMIC_ACQUIRE)
+
+// Most samples a lock-free input queue holds, as many as the arena holds of the maximum size
+#define RMW_UXRCE_INPUT_QUEUE_SIZE RMW_UXRCE_MAX_HISTORY
+#else
+#define RMW_UXRCE_READY_WORD_LOAD(word) (word)
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+
+// FIFO of received samples waiting to be taken by an entity
+typedef struct rmw_uxrce_input_queue_t
+{
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  // Ring of positions, the session thread pushes at tail and the taking thread pops at head.
+  // It is carved from the input buffer arena on the first push, sized from the depth
+  struct rmw_uxrce_static_input_buffer_t ** ring;
+  size_t capacity;
+  size_t positions;
+  size_t head;
+  size_t tail;
+#else
+  struct rmw_uxrce_static_input_buffer_t * head;
+  struct rmw_uxrce_static_input_buffer_t * tail;
+  size_t count;
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+
+  // KEEP_LAST depth: the oldest samples are evicted beyond it, 0 for no limit
+  size_t depth;
+
+  // Kept set while the entity has something to take
+  rmw_uxrce_ready_flag_t ready;
+} rmw_uxrce_input_queue_t;
+
+// Bandwidth budget of a publisher priority class, as a token bucket
+typedef struct rmw_uxrce_priority_class_t
+{
+  size_t budget;
+  int64_t tokens;
+  int64_t last_refill;
+
+  size_t sent_bytes;
+  size_t dropped_samples;
+} rmw_uxrce_priority_class_t;
+
+// Creation requests a deferred entity creation can hold, up to three per endpoint
+#define RMW_UXRCE_MAX_DEFERRED_REQUESTS \
+  (RMW_UXRCE_MAX_NODES + 3 * ((RMW_UXRCE_MAX_PUBLISHERS) + RMW_UXRCE_MAX_SUBSCRIPTIONS) + \
+  RMW_UXRCE_MAX_SERVICES + RMW_UXRCE_MAX_CLIENTS)
+
 typedef struct rmw_context_impl_t
 {
   rmw_uxrce_mempool_item_t mem;
@@ -77,13 +160,32 @@ typedef struct rmw_context_impl_t
   uxrStreamId reliable_input;
   uxrStreamId reliable_output;
   uxrStreamId best_effort_output;
+
+  // Output streams publishers can be moved to, the first ones are the default streams
+  uxrStreamId reliable_outputs[RMW_UXRCE_RELIABLE_OUTPUT_STREAMS];
+  uxrStreamId best_effort_outputs[RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS];
   uxrStreamId best_effort_input;
 
   uxrStreamId * creation_destroy_stream;
 
+  rmw_uxrce_priority_class_t priority_classes[RMW_UXRCE_PRIORITY_CLASSES];
+
+  // Publications are not flushed while a publish batch is open
+  bool publish_batch;
+  bool publish_batch_reliable;
+
+  // Entity requests are not awaited while deferred, their status is collected on commit
+  bool deferred_entities;
+  size_t deferred_count;
+  uint16_t deferred_requests[RMW_UXRCE_MAX_DEFERRED_REQUESTS];
+  uint8_t deferred_status[RMW_UXRCE_MAX_DEFERRED_REQUESTS];
+  uxrObjectId deferred_objects[RMW_UXRCE_MAX_DEFERRED_REQUESTS];
+  size_t deferred_unconfirmed;
+
   uint8_t input_reliable_stream_buffer[RMW_UXRCE_MAX_INPUT_BUFFER_SIZE];
   uint8_t output_reliable_stream_buffer[RMW_UXRCE_MAX_OUTPUT_BUFFER_SIZE];
-  uint8_t output_best_effort_stream_buffer[RMW_UXRCE_MAX_TRANSPORT_MTU];
+  uint8_t output_best_effort_stream_buffer[
+    RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS * RMW_UXRCE_MAX_TRANSPORT_MTU];
 
   uint16_t id_participant;
   uint16_t id_topic;
@@ -93,6 +195,14 @@ typedef struct rmw_context_impl_t
   uint16_t id_datareader;
   uint16_t id_requester;
   uint16_t id_replier;
+
+  rmw_uxrce_entity_table_t subscription_table;
+  rmw_uxrce_entity_table_t service_table;
+  rmw_uxrce_entity_table_t client_table;
+
+  rmw_uxrce_entity_table_entry_t subscription_table_entries[RMW_UXRCE_MAX_SUBSCRIPTIONS];
+  rmw_uxrce_entity_table_entry_t service_table_entries[RMW_UXRCE_MAX_SERVICES];
+  rmw_uxrce_entity_table_entry_t client_table_entries[RMW_UXRCE_MAX_CLIENTS];
 } rmw_context_impl_t;
 
 typedef struct rmw_context_impl_t rmw_uxrce_session_t;
@@ -100,6 +210,11 @@ typedef struct rmw_context_impl_t rmw_uxrce_session_t;
 struct  rmw_init_options_impl_t
 {
   struct rmw_uxrce_transport_params_t transport_params;
+
+  // Pools are carved from this buffer instead of the static ones, if set
+  void * memory_arena;
+  size_t memory_arena_size;
+  rmw_uros_memory_arena_counts_t memory_arena_counts;
 };
 
 // ROS2 entities definitions
@@ -111,6 +226,10 @@ typedef struct rmw_uxrce_topic_t
   uxrObjectId topic_id;
   const message_type_support_callbacks_t * message_type_support_callbacks;
 
+  // Endpoints of the same node, name and type share the topic
+  char topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH + 1];
+  size_t users;
+
   struct rmw_uxrce_node_t * owner_node;
 } rmw_uxrce_topic_t;
 
@@ -126,7 +245,10 @@ typedef struct rmw_uxrce_service_t
   uint8_t history_read_index;
   bool micro_buffer_in_use;
 
+  rmw_uxrce_input_queue_t input_queue;
+
   uxrStreamId stream_id;
+  bool async_reliable;
   struct rmw_uxrce_node_t * owner_node;
 } rmw_uxrce_service_t;
 
@@ -138,10 +260,26 @@ typedef struct rmw_uxrce_client_t
   const service_type_support_callbacks_t * type_support_callbacks;
   uint16_t client_data_request;
 
+  rmw_uxrce_input_queue_t input_queue;
+
   uxrStreamId stream_id;
+  bool async_reliable;
   struct rmw_uxrce_node_t * owner_node;
 } rmw_uxrce_client_t;
 
+// Owner of the zero-copy destination of a subscription
+typedef enum rmw_uxrce_zero_copy_state_t
+{
+  // Held by the user, samples are queued until it is lent again
+  RMW_UXRCE_ZERO_COPY_HELD,
+  // Lent to the session thread, which deserializes the next sample into it
+  RMW_UXRCE_ZERO_COPY_LENT,
+  // Being written by the session thread
+  RMW_UXRCE_ZERO_COPY_FILLING,
+  // Holding a sample until a take hands it back to the user
+  RMW_UXRCE_ZERO_COPY_PENDING
+} rmw_uxrce_zero_copy_state_t;
+
 typedef struct rmw_uxrce_subscription_t
 {
   rmw_uxrce_mempool_item_t mem;
@@ -155,8 +293,42 @@ typedef struct rmw_uxrce_subscription_t
   struct rmw_uxrce_node_t * owner_node;
   rmw_qos_profile_t qos;
   uxrStreamId stream_id;
+
+  rmw_uxrce_input_queue_t input_queue;
+
+  void * zero_copy_destination;
+  rmw_uxrce_zero_copy_state_t zero_copy_state;
+  int64_t zero_copy_timestamp;
+
+  // Size of the messages lent by rmw_take_loaned_message, zero if loans are disabled
+  size_t loan_size;
+  struct rmw_uxrce_static_input_buffer_t * loans;
 } rmw_uxrce_subscription_t;
 
+// Wait set capacity used when the number of conditions is not known on creation
+#define RMW_UXRCE_WAIT_SET_DEFAULT_ENTITIES \
+  (RMW_UXRCE_MAX_SUBSCRIPTIONS + RMW_UXRCE_MAX_SERVICES + RMW_UXRCE_MAX_CLIENTS)
+#define RMW_UXRCE_WAIT_SET_READY_WORDS(entities) (((entities) + 31) / 32)
+
+typedef struct rmw_uxrce_wait_set_t
+{
+  // Registered subscriptions, services and clients, in this order
+  void ** entities;
+  size_t capacity;
+  size_t subscription_count;
+  size_t service_count;
+  size_t client_count;
+
+  bool registered;
+  uint32_t epoch;
+
+  // One bit per registered entity, set while it has something to take
+  uint32_t * ready;
+} rmw_uxrce_wait_set_t;
+
+// Loans are tracked with one bit each
+#define RMW_UXRCE_MAX_PUBLISHER_LOANS 32
+
 typedef struct rmw_uxrce_publisher_t
 {
   rmw_uxrce_mempool_item_t mem;
@@ -174,6 +346,19 @@ typedef struct rmw_uxrce_publisher_t
   rmw_qos_profile_t qos;
   uxrStreamId stream_id;
 
+  // User provided messages lent by rmw_borrow_loaned_message
+  uint8_t * loan_pool;
+  size_t loan_size;
+  size_t loan_count;
+  uint32_t loans_in_use;
+
+  size_t priority;
+
+  // Reliable samples are not confirmed on publish, only counted until acknowledged
+  bool async_reliable;
+  size_t in_flight_samples;
+  size_t in_flight_bytes;
+
   struct rmw_uxrce_node_t * owner_node;
 } rmw_uxrce_publisher_t;
 
@@ -184,84 +369,154 @@ typedef struct rmw_uxrce_node_t
   rmw_context_impl_t * context;
 
   uxrObjectId participant_id;
+
+  // Publisher and subscriber shared by the endpoints of the node, created with the first one
+  uxrObjectId publisher_id;
+  size_t publisher_users;
+  uxrObjectId subscriber_id;
+  size_t subscriber_users;
 } rmw_uxrce_node_t;
 
+// Header of a received sample, its payload follows it in the static buffer arena
 typedef struct rmw_uxrce_static_input_buffer_t
 {
-  rmw_uxrce_mempool_item_t mem;
-
-  uint8_t buffer[RMW_UXRCE_MAX_INPUT_BUFFER_SIZE];
+  uint8_t * buffer;
   size_t length;
   void * owner;
 
+  // Room reserved after the payload for a loaned message, if any
+  void * loan;
+  struct rmw_uxrce_static_input_buffer_t * queue_next;
+  int64_t timestamp;
+
   union {
     int64_t reply_id;
     SampleIdentity sample_id;
   } related;
 } rmw_uxrce_static_input_buffer_t;
 
+// Mangled DDS type name of a type support, computed once and kept for the process lifetime
+typedef struct rmw_uxrce_type_name_t
+{
+  const message_type_support_callbacks_t * members;
+  char name[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+} rmw_uxrce_type_name_t;
+
+// One entry per topic and two per service or client fit the types in use at the same time
+#define RMW_UXRCE_TYPE_NAME_TABLE_SIZE \
+  (RMW_UXRCE_MAX_TOPICS_INTERNAL + 2 * (RMW_UXRCE_MAX_SERVICES + RMW_UXRCE_MAX_CLIENTS))
+
+typedef struct rmw_uxrce_type_name_table_t
+{
+  rmw_uxrce_type_name_t entries[RMW_UXRCE_TYPE_NAME_TABLE_SIZE];
+  size_t count;
+  bool is_initialized;
+
+#ifdef UCLIENT_PROFILE_MULTITHREAD
+  uxrMutex mutex;
+#endif  // UCLIENT_PROFILE_MULTITHREAD
+} rmw_uxrce_type_name_table_t;
+
 // Static memory pools
 
 extern char rmw_uxrce_entity_naming_buffer[RMW_UXRCE_ENTITY_NAMING_BUFFER_LENGTH];
 
 extern rmw_uxrce_mempool_t session_memory;
+extern rmw_uxrce_mempool_t node_memory;
+extern rmw_uxrce_mempool_t publisher_memory;
+extern rmw_uxrce_mempool_t subscription_memory;
+extern rmw_uxrce_mempool_t service_memory;
+extern rmw_uxrce_mempool_t client_memory;
+extern rmw_uxrce_mempool_t topics_memory;
+extern rmw_uxrce_arena_t static_buffer_memory;
+
+// The arena holds the given number of samples of the maximum size, or more smaller ones
+#define RMW_UXRCE_INPUT_BUFFER_ARENA_UNITS(history) \
+  ((history) * RMW_UXRCE_ARENA_BLOCK_UNITS( \
+    sizeof(rmw_uxrce_static_input_buffer_t) + RMW_UXRCE_MAX_INPUT_BUFFER_SIZE))
+#define RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS \
+  RMW_UXRCE_INPUT_BUFFER_ARENA_UNITS(RMW_UXRCE_MAX_HISTORY)
+
+#ifdef RMW_UXRCE_STATIC_MEMORY_POOLS
 extern rmw_context_impl_t custom_sessions[RMW_UXRCE_MAX_SESSIONS];
+extern uint32_t custom_sessions_occupancy[
+  RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_SESSIONS)];
 
-extern rmw_uxrce_mempool_t node_memory;
 extern rmw_uxrce_node_t custom_nodes[RMW_UXRCE_MAX_NODES];
+extern uint32_t custom_nodes_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_NODES)];
 
-extern rmw_uxrce_mempool_t publisher_memory;
 extern rmw_uxrce_publisher_t custom_publishers[RMW_UXRCE_MAX_PUBLISHERS + RMW_UXRCE_MAX_NODES];
+extern uint32_t custom_publishers_occupancy[
+  RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_PUBLISHERS + RMW_UXRCE_MAX_NODES)];
 
-extern rmw_uxrce_mempool_t subscription_memory;
 extern rmw_uxrce_subscription_t custom_subscriptions[RMW_UXRCE_MAX_SUBSCRIPTIONS];
+extern uint32_t custom_subscriptions_occupancy[
+  RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_SUBSCRIPTIONS)];
 
-extern rmw_uxrce_mempool_t service_memory;
 extern rmw_uxrce_service_t custom_services[RMW_UXRCE_MAX_SERVICES];
+extern uint32_t custom_services_occupancy[
+  RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_SERVICES)];
 
-extern rmw_uxrce_mempool_t client_memory;
 extern rmw_uxrce_client_t custom_clients[RMW_UXRCE_MAX_CLIENTS];
+extern uint32_t custom_clients_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_CLIENTS)];
 
-extern rmw_uxrce_mempool_t topics_memory;
 extern rmw_uxrce_topic_t custom_topics[RMW_UXRCE_MAX_TOPICS_INTERNAL];
+extern uint32_t custom_topics_occupancy[
+  RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(RMW_UXRCE_MAX_TOPICS_INTERNAL)];
 
-extern rmw_uxrce_mempool_t static_buffer_memory;
-extern rmw_uxrce_static_input_buffer_t custom_static_buffers[RMW_UXRCE_MAX_HISTORY];
+extern rmw_uxrce_arena_unit_t custom_static_buffers[RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS];
+#endif  // RMW_UXRCE_STATIC_MEMORY_POOLS
+
+extern rmw_uxrce_type_name_table_t type_name_table;
 
 // Memory init functions
 
 void rmw_uxrce_init_session_memory(
   rmw_uxrce_mempool_t * memory,
   rmw_context_impl_t * sessions,
+  uint32_t * occupancy,
   size_t size);
 void rmw_uxrce_init_node_memory(
   rmw_uxrce_mempool_t * memory,
   rmw_uxrce_node_t * nodes,
+  uint32_t * occupancy,
   size_t size);
 void rmw_uxrce_init_service_memory(
   rmw_uxrce_mempool_t * memory,
   rmw_uxrce_service_t * services,
+  uint32_t * occupancy,
   size_t size);
 void rmw_uxrce_init_client_memory(
   rmw_uxrce_mempool_t * memory,
   rmw_uxrce_client_t * clients,
+  uint32_t * occupancy,
   size_t size);
 void rmw_uxrce_init_publisher_memory(
   rmw_uxrce_mempool_t * memory,
   rmw_uxrce_publisher_t * publishers,
+  uint32_t * occupancy,
   size_t size);
 void rmw_uxrce_init_subscription_memory(
   rmw_uxrce_mempool_t * memory,
   rmw_uxrce_subscription_t * subscribers,
+  uint32_t * occupancy,
   size_t size);
 void rmw_uxrce_init_topic_memory(
   rmw_uxrce_mempool_t * memory,
   rmw_uxrce_topic_t * topics,
+  uint32_t * occupancy,
   size_t size);
 void rmw_uxrce_init_static_input_buffer_memory(
-  rmw_uxrce_mempool_t * memory,
-  rmw_uxrce_static_input_buffer_t * buffers,
+  rmw_uxrce_arena_t * memory,
+  rmw_uxrce_arena_unit_t * units,
   size_t size);
+void rmw_uxrce_init_type_name_table(
+  rmw_uxrce_type_name_table_t * table);
+size_t rmw_uxrce_memory_arena_size(
+  const rmw_uros_memory_arena_counts_t * counts);
+void rmw_uxrce_init_memory_arena(
+  void * buffer,
+  const rmw_uros_memory_arena_counts_t * counts);
 
 // Memory management functions
 
@@ -280,7 +535,123 @@ void rmw_uxrce_fini_service_memory(
 void rmw_uxrce_fini_topic_memory(
   rmw_uxrce_topic_t * topic);
 
-rmw_uxrce_mempool_item_t * rmw_uxrce_find_static_input_buffer_by_owner(
-  void * owner);
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_get_static_input_buffer(
+  size_t length);
+void rmw_uxrce_put_static_input_buffer(
+  rmw_uxrce_static_input_buffer_t * static_buffer);
+void rmw_uxrce_put_static_input_buffer_list(
+  rmw_uxrce_static_input_buffer_t * static_buffer);
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_get_loanable_static_input_buffer(
+  size_t length,
+  size_t loan_size);
+
+// Input queue functions
+
+void rmw_uxrce_input_queue_init(
+  rmw_uxrce_input_queue_t * queue);
+bool rmw_uxrce_input_queue_push(
+  rmw_uxrce_input_queue_t * queue,
+  rmw_uxrce_static_input_buffer_t * static_buffer);
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_input_queue_pop(
+  rmw_uxrce_input_queue_t * queue);
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_input_queue_pop_batch(
+  rmw_uxrce_input_queue_t * queue,
+  size_t max_count,
+  size_t * count);
+bool rmw_uxrce_input_queue_has_data(
+  const rmw_uxrce_input_queue_t * queue);
+size_t rmw_uxrce_input_queue_count(
+  const rmw_uxrce_input_queue_t * queue);
+void rmw_uxrce_input_queue_detach(
+  rmw_uxrce_input_queue_t * queue);
+void rmw_uxrce_input_queue_flush(
+  rmw_uxrce_input_queue_t * queue);
+void rmw_uxrce_input_queue_fini(
+  rmw_uxrce_input_queue_t * queue);
+void rmw_uxrce_input_queue_set_depth(
+  rmw_uxrce_input_queue_t * queue,
+  size_t depth);
+void rmw_uxrce_input_queue_make_room(
+  rmw_uxrce_input_queue_t * queue);
+bool rmw_uxrce_input_queue_evict(
+  rmw_uxrce_input_queue_t * queue);
+void rmw_uxrce_input_queue_set_ready(
+  rmw_uxrce_input_queue_t * queue,
+  bool ready);
+
+// Publisher loan functions
+
+void * rmw_uxrce_publisher_get_loan(
+  rmw_uxrce_publisher_t * publisher);
+bool rmw_uxrce_publisher_put_loan(
+  rmw_uxrce_publisher_t * publisher,
+  void * loaned_message);
+
+// Publisher in-flight functions
+
+void rmw_uxrce_publisher_push_in_flight(
+  rmw_uxrce_publisher_t * publisher,
+  size_t bytes);
+void rmw_uxrce_publisher_purge_in_flight(
+  rmw_uxrce_publisher_t * publisher);
+
+// Priority class functions
+
+void rmw_uxrce_init_priority_classes(
+  rmw_uxrce_priority_class_t * classes,
+  size_t size);
+bool rmw_uxrce_priority_class_admit(
+  rmw_uxrce_priority_class_t * priority_class,
+  size_t bytes);
+
+// Subscription loan functions
+
+void rmw_uxrce_subscription_push_loan(
+  rmw_uxrce_subscription_t * subscription,
+  rmw_uxrce_static_input_buffer_t * static_buffer);
+rmw_uxrce_static_input_buffer_t * rmw_uxrce_subscription_pop_loan(
+  rmw_uxrce_subscription_t * subscription,
+  void * loaned_message);
+void rmw_uxrce_subscription_flush_loans(
+  rmw_uxrce_subscription_t * subscription);
+
+// Wait set functions
+
+void rmw_uxrce_wait_set_init(
+  rmw_uxrce_wait_set_t * wait_set,
+  void ** entities,
+  uint32_t * ready,
+  size_t capacity);
+bool rmw_uxrce_wait_set_register(
+  rmw_uxrce_wait_set_t * wait_set,
+  rmw_subscriptions_t * subscriptions,
+  rmw_services_t * services,
+  rmw_clients_t * clients);
+void rmw_uxrce_wait_set_unregister(
+  rmw_uxrce_wait_set_t * wait_set);
+bool rmw_uxrce_wait_set_is_ready(
+  rmw_uxrce_wait_set_t * wait_set);
+
+// Entity table functions
+
+void rmw_uxrce_init_entity_table(
+  rmw_uxrce_entity_table_t * table,
+  rmw_uxrce_entity_table_entry_t * entries,
+  size_t size);
+uxrObjectId rmw_uxrce_entity_table_next_id(
+  rmw_uxrce_entity_table_t * table,
+  uint16_t * id_counter,
+  uint8_t type);
+void rmw_uxrce_entity_table_insert(
+  rmw_uxrce_entity_table_t * table,
+  uxrObjectId object_id,
+  void * entity);
+void rmw_uxrce_entity_table_remove(
+  rmw_uxrce_entity_table_t * table,
+  uxrObjectId object_id,
+  void * entity);
+void * rmw_uxrce_entity_table_find(
+  rmw_uxrce_entity_table_t * table,
+  uxrObjectId object_id);
 
 #endif  // TYPES_H_
@@ -16,6 +16,8 @@
 
 #include <rmw/error_handling.h>
 
+#include <uxr/client/util/time.h>
+
 #include "./types.h"
 
 
@@ -31,15 +33,57 @@ bool run_xrce_session(
   rmw_context_impl_t * context,
   uint16_t requests)
 {
-  if (context->creation_destroy_stream->type == UXR_BEST_EFFORT_STREAM) {
+  return run_xrce_session_all(context, &requests, 1);
+}
+
+bool run_xrce_session_all(
+  rmw_context_impl_t * context,
+  uint16_t * requests,
+  size_t count)
+{
+  if (count > RMW_UXRCE_MAX_PIPELINED_REQUESTS) {
+    RMW_SET_ERROR_MSG("too many pipelined requests");
+    return false;
+  }
+
+  // Requests that could not be buffered never reach the agent
+  for (size_t i = 0; i < count; i++) {
+    if (UXR_INVALID_REQUEST_ID == requests[i]) {
+      RMW_SET_ERROR_MSG("request could not be buffered");
+      return false;
+    }
+  }
+
+  if (0 == count) {
+    return true;
+  } else if (context->creation_destroy_stream->type == UXR_BEST_EFFORT_STREAM) {
     uxr_flash_output_streams(&context->session);
+  } else if (context->deferred_entities) {
+    if (context->deferred_count + count > RMW_UXRCE_MAX_DEFERRED_REQUESTS) {
+      RMW_SET_ERROR_MSG("too many deferred requests");
+      return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+      context->deferred_requests[context->deferred_count] = requests[i];
+      context->deferred_status[context->deferred_count] = UXR_STATUS_NONE;
+      context->deferred_count++;
+    }
+
+    // Requests stay in the stream until the commit, unless it could not hold the next entity.
+    // The requests of an entity fit in one MTU, so each unconfirmed entity is counted as a slot
+    // of the stream history, and the next one needs a spare slot besides the one being filled
+    if (++context->deferred_unconfirmed + 2 > RMW_UXRCE_STREAM_HISTORY_OUTPUT_PER_STREAM) {
+      context->deferred_unconfirmed = 0;
+      return uxr_run_session_until_confirm_delivery(
+        &context->session, RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT);
+    }
   } else {
-    // This only handles one request at time
-    uint8_t status;
+    // Requests are sent together and their status awaited in a single round trip
+    uint8_t status[RMW_UXRCE_MAX_PIPELINED_REQUESTS];
     if (!uxr_run_session_until_all_status(
         &context->session,
         RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT,
-        &requests, &status, 1))
+        requests, status, count))
     {
       RMW_SET_ERROR_MSG("Issues running micro XRCE-DDS session");
       return false;
@@ -48,6 +92,33 @@ bool run_xrce_session(
   return true;
 }
 
+bool run_xrce_session_until_deferred_status(
+  rmw_context_impl_t * context)
+{
+  // Statuses are stored by on_status as they arrive
+  int64_t deadline = uxr_millis() + RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT;
+
+  uxr_flash_output_streams(&context->session);
+  while (true) {
+    bool pending = false;
+    bool succeeded = true;
+    for (size_t i = 0; i < context->deferred_count; i++) {
+      uint8_t status = context->deferred_status[i];
+      pending |= UXR_STATUS_NONE == status;
+      succeeded &= UXR_STATUS_OK == status || UXR_STATUS_OK_MATCHED == status;
+    }
+    if (!pending) {
+      return succeeded;
+    }
+
+    int64_t remaining = deadline - uxr_millis();
+    if (remaining <= 0) {
+      return false;
+    }
+    uxr_run_session_until_timeout(&context->session, (int)remaining);
+  }
+}
+
 int build_participant_xml(
   size_t domain_id,
   const char * participant_name,
@@ -103,10 +174,20 @@ int generate_service_types(
   const message_type_support_callbacks_t * res_callbacks =
     (const message_type_support_callbacks_t *)res_members->data;
 
-  generate_type_name(req_callbacks, request_type, buffer_size);
-  generate_type_name(res_callbacks, reply_type, buffer_size);
+  // Names are copied from the type name table unless they were generated in place
+  const char * request_name = get_type_name(req_callbacks, request_type, buffer_size);
+  const char * reply_name = get_type_name(res_callbacks, reply_type, buffer_size);
+  if (NULL == request_name || NULL == reply_name) {
+    return 0;
+  }
+  if (request_name != request_type) {
+    snprintf(request_type, buffer_size, "%s", request_name);
+  }
+  if (reply_name != reply_type) {
+    snprintf(reply_type, buffer_size, "%s", reply_name);
+  }
 
-  return 0;
+  return 1;
 }
 
 int build_service_xml(
@@ -139,12 +220,15 @@ int build_service_xml(
   const message_type_support_callbacks_t * res_callbacks =
     (const message_type_support_callbacks_t *)res_members->data;
 
-
-  static char req_type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
-  static char res_type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
-
-  generate_type_name(req_callbacks, req_type_name_buffer, RMW_UXRCE_TYPE_NAME_MAX_LENGTH);
-  generate_type_name(res_callbacks, res_type_name_buffer, RMW_UXRCE_TYPE_NAME_MAX_LENGTH);
+  char req_type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  char res_type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  const char * req_type_name = get_type_name(
+    req_callbacks, req_type_name_buffer, sizeof(req_type_name_buffer));
+  const char * res_type_name = get_type_name(
+    res_callbacks, res_type_name_buffer, sizeof(res_type_name_buffer));
+  if (NULL == req_type_name || NULL == res_type_name) {
+    return 0;
+  }
 
   // Generate request and reply topic names
   char req_full_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH + 1 + sizeof(ros_request_prefix) + 1 +
@@ -186,8 +270,8 @@ int build_service_xml(
     requester ? "requester" : "replier",
     service_name_id,
     service_name,
-    req_type_name_buffer,
-    res_type_name_buffer,
+    req_type_name,
+    res_type_name,
     req_full_topic_name,
     res_full_topic_name,
     requester ? "requester" : "replier"
@@ -241,6 +325,43 @@ int generate_name(
   return ret;
 }
 
+const char * get_type_name(
+  const message_type_support_callbacks_t * members,
+  char buffer[],
+  size_t buffer_size)
+{
+  const char * type_name = NULL;
+
+  UXR_LOCK(&type_name_table.mutex);
+  for (size_t i = 0; i < type_name_table.count; i++) {
+    if (type_name_table.entries[i].members == members) {
+      type_name = type_name_table.entries[i].name;
+      break;
+    }
+  }
+  // Only names that fit are kept, a truncated one would be reused by every later entity
+  if (NULL == type_name && type_name_table.count < RMW_UXRCE_TYPE_NAME_TABLE_SIZE) {
+    rmw_uxrce_type_name_t * entry = &type_name_table.entries[type_name_table.count];
+    size_t name_size = generate_type_name(members, entry->name, sizeof(entry->name));
+    if (0 != name_size && name_size <= sizeof(entry->name)) {
+      entry->members = members;
+      type_name_table.count++;
+      type_name = entry->name;
+    }
+  }
+  UXR_UNLOCK(&type_name_table.mutex);
+
+  // Types beyond the table are named in the caller buffer every time
+  if (NULL == type_name) {
+    size_t name_size = generate_type_name(members, buffer, buffer_size);
+    if (0 != name_size && name_size <= buffer_size) {
+      type_name = buffer;
+    }
+  }
+
+  return type_name;
+}
+
 size_t generate_type_name(
   const message_type_support_callbacks_t * members,
   char type_name[],
@@ -303,11 +424,10 @@ int build_topic_xml(
     "</dds>";
 
   int ret = 0;
-  static char type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  char type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  const char * type_name = get_type_name(members, type_name_buffer, sizeof(type_name_buffer));
 
-  if (RMW_UXRCE_TOPIC_NAME_MAX_LENGTH >= strlen(topic_name) &&
-    0 != generate_type_name(members, type_name_buffer, sizeof(type_name_buffer)))
-  {
+  if (RMW_UXRCE_TOPIC_NAME_MAX_LENGTH >= strlen(topic_name) && NULL != type_name) {
     char full_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH + 1 + sizeof(ros_topic_prefix)];
 
     if (!qos_policies->avoid_ros_namespace_conventions) {
@@ -324,7 +444,7 @@ int build_topic_xml(
       }
     }
 
-    ret = snprintf(xml, buffer_size, format, full_topic_name, type_name_buffer);
+    ret = snprintf(xml, buffer_size, format, full_topic_name, type_name);
     if ((ret < 0) && (ret >= (int)buffer_size)) {
       ret = 0;
     }
@@ -342,40 +462,42 @@ int build_xml(
   size_t buffer_size)
 {
   int ret = 0;
-  static char type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
-
-  if (0 != generate_type_name(members, type_name_buffer, sizeof(type_name_buffer))) {
-    char full_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH + 1 + sizeof(ros_topic_prefix)];
-    full_topic_name[0] = '\0';
+  char type_name_buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  const char * type_name = get_type_name(members, type_name_buffer, sizeof(type_name_buffer));
+  if (NULL == type_name) {
+    return 0;
+  }
 
-    if (!qos_policies->avoid_ros_namespace_conventions) {
-      ret = snprintf(
-        full_topic_name, sizeof(full_topic_name), "%s%s", ros_topic_prefix,
-        topic_name);
-      if ((ret < 0) && (ret >= (int)buffer_size)) {
-        return 0;
-      }
-    } else {
-      ret = snprintf(full_topic_name, sizeof(full_topic_name), "%s", topic_name);
-      if ((ret < 0) && (ret >= (int)buffer_size)) {
-        return 0;
-      }
-    }
+  char full_topic_name[RMW_UXRCE_TOPIC_NAME_MAX_LENGTH + 1 + sizeof(ros_topic_prefix)];
+  full_topic_name[0] = '\0';
 
+  if (!qos_policies->avoid_ros_namespace_conventions) {
     ret = snprintf(
-      xml,
-      buffer_size,
-      format,
-      (qos_policies->reliability == RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT) ?
-      "BEST_EFFORT" : "RELIABLE",
-      full_topic_name,
-      type_name_buffer);
-
+      full_topic_name, sizeof(full_topic_name), "%s%s", ros_topic_prefix,
+      topic_name);
     if ((ret < 0) && (ret >= (int)buffer_size)) {
-      ret = 0;
+      return 0;
+    }
+  } else {
+    ret = snprintf(full_topic_name, sizeof(full_topic_name), "%s", topic_name);
+    if ((ret < 0) && (ret >= (int)buffer_size)) {
+      return 0;
     }
   }
 
+  ret = snprintf(
+    xml,
+    buffer_size,
+    format,
+    (qos_policies->reliability == RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT) ?
+    "BEST_EFFORT" : "RELIABLE",
+    full_topic_name,
+    type_name);
+
+  if ((ret < 0) && (ret >= (int)buffer_size)) {
+    ret = 0;
+  }
+
   return ret;
 }
 
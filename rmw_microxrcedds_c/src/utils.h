@@ -19,15 +19,36 @@
 
 #include "./types.h"
 
+#if defined(__cplusplus)
+extern "C"
+{
+#endif  // if defined(__cplusplus)
+
+// Requests buffered back to back by a single entity creation or destruction
+#define RMW_UXRCE_MAX_PIPELINED_REQUESTS 4
+
 bool run_xrce_session(
   rmw_context_impl_t * context,
   uint16_t requests);
 
+bool run_xrce_session_all(
+  rmw_context_impl_t * context,
+  uint16_t * requests,
+  size_t count);
+
+bool run_xrce_session_until_deferred_status(
+  rmw_context_impl_t * context);
+
 int generate_name(
   const uxrObjectId * id,
   char name[],
   size_t buffer_size);
 
+const char * get_type_name(
+  const message_type_support_callbacks_t * members,
+  char buffer[],
+  size_t buffer_size);
+
 size_t generate_type_name(
   const message_type_support_callbacks_t * members,
   char type_name[],
@@ -110,4 +131,8 @@ bool build_datareader_profile(
 bool is_uxrce_rmw_identifier_valid(
   const char * id);
 
+#if defined(__cplusplus)
+}
+#endif  // if defined(__cplusplus)
+
 #endif  // UTILS_H_
@@ -0,0 +1,480 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <rmw/error_handling.h>
+#include <rmw/rmw.h>
+#include <rmw_microros/rmw_microros.h>
+
+#include "./callbacks_base_test.hpp"
+
+static size_t deserialized_bytes = 0;
+
+static bool benchmark_deserialize(
+  ucdrBuffer * cdr,
+  void * untyped_ros_message)
+{
+  benchmark_message_t * ros_message = reinterpret_cast<benchmark_message_t *>(untyped_ros_message);
+  ros_message->size = ucdr_buffer_remaining(cdr);
+  deserialized_bytes += ros_message->size;
+  return ucdr_deserialize_array_uint8_t(cdr, ros_message->data, ros_message->size);
+}
+
+/*
+ * Benchmarking on_topic dispatch with synthetic samples for an increasing number of readers.
+ */
+TEST_F(TestCallbacks, on_topic_dispatch_benchmark)
+{
+  const size_t readers[] = {1, 8, 64, 256};
+
+  fprintf(stderr, "| Readers | Dispatch table | Linear scan |\n");
+  fprintf(stderr, "| - | - | - |\n");
+
+  for (size_t count : readers) {
+    SetUp();
+    rmw_uxrce_subscription_t * target = create_readers(count, true);
+    double table_ns = dispatch_ns_per_sample(target);
+    TearDown();
+
+    SetUp();
+    target = create_readers(count, false);
+    double scan_ns = dispatch_ns_per_sample(target);
+    TearDown();
+
+    ASSERT_GT(table_ns, 0.0);
+    ASSERT_GT(scan_ns, 0.0);
+    fprintf(stderr, "| %zu | %.1f ns | %.1f ns |\n", count, table_ns, scan_ns);
+  }
+}
+
+/*
+ * Benchmarking bytes copied per sample with and without a zero-copy destination.
+ */
+TEST_F(TestCallbacks, zero_copy_benchmark)
+{
+  static uint8_t payload[RMW_UXRCE_MAX_INPUT_BUFFER_SIZE];
+  static benchmark_message_t message;
+  message_type_support_callbacks_t callbacks = {};
+  callbacks.cdr_deserialize = benchmark_deserialize;
+
+  rmw_uxrce_subscription_t * target = create_readers(1, true);
+  target->type_support_callbacks = &callbacks;
+  target->zero_copy_destination = NULL;
+  target->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+
+  rmw_subscription_t subscription = {};
+  subscription.implementation_identifier = rmw_get_implementation_identifier();
+  subscription.data = target;
+
+  fprintf(stderr, "| Mode | Payload | Bytes copied per sample | Time per sample |\n");
+  fprintf(stderr, "| - | - | - | - |\n");
+
+  const bool modes[] = {false, true};
+  for (bool zero_copy : modes) {
+    if (zero_copy) {
+      ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, &message), RMW_RET_OK);
+    }
+
+    size_t copied_bytes = 0;
+    deserialized_bytes = 0;
+    ucdrBuffer ub;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCHMARK_SAMPLES / 10; i++) {
+      ucdr_init_buffer(&ub, payload, sizeof(payload));
+      on_topic(
+        &benchmark_context.session, target->datareader_id, 0,
+        benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+
+      if (rmw_uxrce_input_queue_has_data(&target->input_queue)) {
+        copied_bytes += sizeof(payload);
+      }
+
+      bool taken = false;
+      ASSERT_EQ(rmw_take(&subscription, &message, &taken, NULL), RMW_RET_OK);
+      ASSERT_TRUE(taken);
+      ASSERT_EQ(message.size, sizeof(payload));
+
+      // The destination is lent again once the sample has been read
+      if (zero_copy) {
+        ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, &message), RMW_RET_OK);
+      }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    copied_bytes += deserialized_bytes;
+    fprintf(
+      stderr, "| %s | %zu B | %zu B | %.1f ns |\n", zero_copy ? "Zero-copy" : "Static buffer",
+      sizeof(payload), copied_bytes / (BENCHMARK_SAMPLES / 10),
+      std::chrono::duration<double, std::nano>(elapsed).count() / (BENCHMARK_SAMPLES / 10));
+  }
+
+  ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, NULL), RMW_RET_OK);
+}
+
+/*
+ * Benchmarking per-message cost of rmw_take_sequence against single takes.
+ */
+TEST_F(TestCallbacks, take_sequence_benchmark)
+{
+  const size_t batch_sizes[] = {1, 16, 64};
+  const size_t max_batch = 64;
+  const size_t iterations = 1000;
+
+  uint8_t payload[16] = {0};
+  message_type_support_callbacks_t callbacks = {};
+  callbacks.cdr_deserialize = benchmark_deserialize;
+
+  rmw_uxrce_subscription_t * target = create_readers(1, true);
+  target->type_support_callbacks = &callbacks;
+  target->zero_copy_destination = NULL;
+  target->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+
+  rmw_subscription_t subscription = {};
+  subscription.implementation_identifier = rmw_get_implementation_identifier();
+  subscription.data = target;
+
+  std::vector<benchmark_message_t> messages(max_batch);
+  std::vector<void *> message_pointers(max_batch);
+  std::vector<rmw_message_info_t> message_infos(max_batch);
+  for (size_t i = 0; i < max_batch; i++) {
+    message_pointers[i] = &messages[i];
+  }
+
+  rmw_message_sequence_t message_sequence = rmw_get_zero_initialized_message_sequence();
+  message_sequence.data = message_pointers.data();
+  message_sequence.capacity = max_batch;
+  rmw_message_info_sequence_t message_info_sequence =
+    rmw_get_zero_initialized_message_info_sequence();
+  message_info_sequence.data = message_infos.data();
+  message_info_sequence.capacity = max_batch;
+
+  fprintf(stderr, "| Batch | rmw_take_sequence | rmw_take |\n");
+  fprintf(stderr, "| - | - | - |\n");
+
+  for (size_t batch : batch_sizes) {
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+    // Lock-free queues do not hold larger batches
+    if (batch > RMW_UXRCE_INPUT_QUEUE_SIZE) {
+      continue;
+    }
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+    double elapsed_ns[2] = {0.0, 0.0};
+
+    for (size_t mode = 0; mode < 2; mode++) {
+      for (size_t it = 0; it < iterations; it++) {
+        ucdrBuffer ub;
+        for (size_t i = 0; i < batch; i++) {
+          payload[0] = static_cast<uint8_t>(i);
+          ucdr_init_buffer(&ub, payload, sizeof(payload));
+          on_topic(
+            &benchmark_context.session, target->datareader_id, 0,
+            benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+        }
+        ASSERT_EQ(rmw_uxrce_input_queue_count(&target->input_queue), batch);
+
+        size_t taken = 0;
+        auto start = std::chrono::steady_clock::now();
+        if (mode == 0) {
+          ASSERT_EQ(
+            rmw_take_sequence(
+              &subscription, batch, &message_sequence, &message_info_sequence, &taken,
+              NULL), RMW_RET_OK);
+        } else {
+          bool taken_flag = true;
+          while (taken < batch && taken_flag) {
+            ASSERT_EQ(
+              rmw_take_with_info(
+                &subscription, &messages[taken], &taken_flag, &message_infos[taken], NULL),
+              RMW_RET_OK);
+            taken++;
+          }
+        }
+        elapsed_ns[mode] += std::chrono::duration<double, std::nano>(
+          std::chrono::steady_clock::now() - start).count();
+
+        ASSERT_EQ(taken, batch);
+        for (size_t i = 0; i < batch; i++) {
+          ASSERT_EQ(messages[i].data[0], static_cast<uint8_t>(i));
+        }
+      }
+    }
+
+    fprintf(
+      stderr, "| %zu | %.1f ns/msg | %.1f ns/msg |\n", batch,
+      elapsed_ns[0] / (iterations * batch), elapsed_ns[1] / (iterations * batch));
+  }
+
+  rmw_uxrce_input_queue_fini(&target->input_queue);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+}
+
+/*
+ * Benchmarking rmw_wait cost for an increasing number of subscriptions with one of them ready.
+ */
+TEST_F(TestCallbacks, wait_set_benchmark)
+{
+  const size_t readers[] = {1, 8, 64, 256};
+  const size_t iterations = 10000;
+
+  fprintf(stderr, "| Subscriptions | Stateful wait set | Stateless |\n");
+  fprintf(stderr, "| - | - | - |\n");
+
+  rmw_wait_set_t * wait_set = rmw_create_wait_set(NULL, BENCHMARK_MAX_READERS);
+  ASSERT_NE(wait_set, nullptr);
+
+  for (size_t count : readers) {
+    SetUp();
+    create_readers(count, true);
+
+    std::vector<void *> handles;
+    rmw_uxrce_mempool_cursor_t cursor;
+    for (rmw_uxrce_mempool_item_t * item = first_memory(&subscription_memory, &cursor);
+      item != NULL; item = next_memory(&subscription_memory, &cursor))
+    {
+      rmw_uxrce_subscription_t * custom_subscription =
+        reinterpret_cast<rmw_uxrce_subscription_t *>(item->data);
+      custom_subscription->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+      handles.push_back(custom_subscription);
+    }
+
+    // The last subscription in the array is the only one with data
+    rmw_uxrce_subscription_t * target = reinterpret_cast<rmw_uxrce_subscription_t *>(
+      handles.back());
+    uint8_t payload = 0;
+    ucdrBuffer ub;
+    ucdr_init_buffer(&ub, &payload, sizeof(payload));
+    on_topic(
+      &benchmark_context.session, target->datareader_id, 0,
+      benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+
+    double elapsed_ns[2] = {0.0, 0.0};
+    std::vector<void *> entities(count);
+    rmw_subscriptions_t subscriptions;
+    subscriptions.subscribers = entities.data();
+    subscriptions.subscriber_count = count;
+    rmw_time_t timeout = {0, 0};
+
+    for (size_t mode = 0; mode < 2; mode++) {
+      for (size_t it = 0; it < iterations; it++) {
+        // Executors refill the arrays before every wait
+        std::copy(handles.begin(), handles.end(), entities.begin());
+
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_EQ(
+          rmw_wait(
+            &subscriptions, NULL, NULL, NULL, NULL, (mode == 0) ? wait_set : NULL,
+            &timeout), RMW_RET_OK);
+        elapsed_ns[mode] += std::chrono::duration<double, std::nano>(
+          std::chrono::steady_clock::now() - start).count();
+
+        ASSERT_EQ(entities[count - 1], target);
+      }
+    }
+
+    fprintf(
+      stderr, "| %zu | %.1f ns | %.1f ns |\n", count,
+      elapsed_ns[0] / iterations, elapsed_ns[1] / iterations);
+
+    rmw_uxrce_input_queue_flush(&target->input_queue);
+    TearDown();
+  }
+
+  ASSERT_EQ(rmw_destroy_wait_set(wait_set), RMW_RET_OK);
+}
+
+/*
+ * Benchmarking the receive path with a session thread producing through on_topic
+ * and an executor thread consuming through rmw_take, as with a dedicated session thread.
+ */
+TEST_F(TestCallbacks, receive_path_spsc_benchmark)
+{
+  static benchmark_message_t message;
+  message_type_support_callbacks_t callbacks = {};
+  callbacks.cdr_deserialize = benchmark_deserialize;
+
+  rmw_uxrce_subscription_t * target = create_readers(1, true);
+  target->type_support_callbacks = &callbacks;
+  target->zero_copy_destination = NULL;
+  target->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+  target->loan_size = 0;
+
+  rmw_subscription_t subscription = {};
+  subscription.implementation_identifier = rmw_get_implementation_identifier();
+  subscription.data = target;
+
+  std::atomic<size_t> failed(0);
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::thread producer(
+    [&]() {
+      uint8_t payload[BENCHMARK_PAYLOAD] = {0};
+      ucdrBuffer ub;
+      for (size_t i = 0; i < BENCHMARK_SAMPLES; i++) {
+        // Samples are not dropped while the executor keeps up
+        while (rmw_uxrce_input_queue_count(&target->input_queue) >= RMW_UXRCE_MAX_HISTORY) {
+        }
+        payload[0] = static_cast<uint8_t>(i);
+        ucdr_init_buffer(&ub, payload, sizeof(payload));
+        on_topic(
+          &benchmark_context.session, target->datareader_id, 0,
+          benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+      }
+    });
+
+  std::thread consumer(
+    [&]() {
+      for (size_t i = 0; i < BENCHMARK_SAMPLES; i++) {
+        bool taken = false;
+        while (!taken) {
+          (void)rmw_take(&subscription, &message, &taken, NULL);
+        }
+        if (message.size != BENCHMARK_PAYLOAD || message.data[0] != static_cast<uint8_t>(i)) {
+          failed++;
+        }
+      }
+    });
+
+  producer.join();
+  consumer.join();
+
+  double elapsed_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+  rmw_reset_error();
+
+  ASSERT_EQ(failed.load(), 0u);
+  ASSERT_FALSE(rmw_uxrce_input_queue_has_data(&target->input_queue));
+  rmw_uxrce_input_queue_fini(&target->input_queue);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+
+#ifdef RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  const char * mode = "lock-free";
+#else
+  const char * mode = "locked";
+#endif  // RMW_UXRCE_LOCK_FREE_INPUT_BUFFERS
+  fprintf(stderr, "| Mode | Samples per second |\n");
+  fprintf(stderr, "| - | - |\n");
+  fprintf(stderr, "| %s | %.0f |\n", mode, BENCHMARK_SAMPLES / elapsed_s);
+}
+
+/*
+ * Benchmarking a walk over allocated subscriptions against the former doubly linked item list,
+ * both with the pool in cache and after evicting it as between two executor spins.
+ */
+TEST_F(TestCallbacks, pool_iteration_benchmark)
+{
+  typedef struct legacy_item_t
+  {
+    struct legacy_item_t * prev;
+    struct legacy_item_t * next;
+    void * data;
+    bool is_dynamic_memory;
+  } legacy_item_t;
+
+  const size_t readers[] = {8, 64, 256};
+  const size_t iterations = 10000;
+  const size_t evicted_iterations = 100;
+  const size_t item_offset = offsetof(rmw_uxrce_subscription_t, mem);
+  std::vector<uint8_t> eviction_buffer(16 * 1024 * 1024);
+
+  fprintf(stderr, "| Subscriptions | Occupancy | Cache | Index pool | Linked list |\n");
+  fprintf(stderr, "| - | - | - | - | - |\n");
+
+  for (size_t count : readers) {
+    for (size_t stride : {1, 2}) {
+      SetUp();
+      create_readers(count, true);
+
+      // Every other subscription is released to get a sparse pool
+      std::vector<rmw_uxrce_subscription_t *> allocated;
+      size_t position = 0;
+      rmw_uxrce_mempool_cursor_t cursor;
+      rmw_uxrce_mempool_item_t * item = first_memory(&subscription_memory, &cursor);
+      while (item != NULL) {
+        rmw_uxrce_mempool_item_t * next = next_memory(&subscription_memory, &cursor);
+        if (position++ % stride == 0) {
+          allocated.push_back(reinterpret_cast<rmw_uxrce_subscription_t *>(item->data));
+        } else {
+          put_memory(&subscription_memory, item);
+        }
+        item = next;
+      }
+
+      // Former layout: items embedded at the same place, linked newest first
+      std::vector<uint8_t> legacy_storage(count * sizeof(rmw_uxrce_subscription_t));
+      legacy_item_t * legacy_head = NULL;
+      for (size_t i = 0; i < count; i += stride) {
+        uint8_t * element = &legacy_storage[i * sizeof(rmw_uxrce_subscription_t)];
+        legacy_item_t * legacy = reinterpret_cast<legacy_item_t *>(element + item_offset);
+        legacy->data = element;
+        legacy->prev = NULL;
+        legacy->next = legacy_head;
+        legacy_head = legacy;
+      }
+
+      for (bool evicted : {false, true}) {
+        const size_t walks = evicted ? evicted_iterations : iterations;
+        size_t visited[2] = {0, 0};
+        double elapsed_ns[2] = {0.0, 0.0};
+
+        for (size_t it = 0; it < walks; it++) {
+          for (size_t mode = 0; mode < 2; mode++) {
+            if (evicted) {
+              for (size_t i = 0; i < eviction_buffer.size(); i += 64) {
+                eviction_buffer[i]++;
+              }
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            if (mode == 0) {
+              for (item = first_memory(&subscription_memory, &cursor); item != NULL;
+                item = next_memory(&subscription_memory, &cursor))
+              {
+                visited[0] += (item->data != NULL);
+              }
+            } else {
+              for (legacy_item_t * legacy = legacy_head; legacy != NULL; legacy = legacy->next) {
+                visited[1] += (legacy->data != NULL);
+              }
+            }
+            elapsed_ns[mode] += std::chrono::duration<double, std::nano>(
+              std::chrono::steady_clock::now() - start).count();
+          }
+        }
+
+        ASSERT_EQ(visited[0], allocated.size() * walks);
+        ASSERT_EQ(visited[1], allocated.size() * walks);
+        fprintf(
+          stderr, "| %zu | 1/%zu | %s | %.1f ns | %.1f ns |\n", count, stride,
+          evicted ? "Evicted" : "Hot", elapsed_ns[0] / walks, elapsed_ns[1] / walks);
+
+        // Out of cache the bitmap is scanned without chasing one element per item
+        if (evicted && allocated.size() >= 32) {
+          ASSERT_LE(elapsed_ns[0], elapsed_ns[1]);
+        }
+      }
+
+      TearDown();
+    }
+  }
+}
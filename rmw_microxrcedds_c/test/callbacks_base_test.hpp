@@ -0,0 +1,129 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CALLBACKS_BASE_TEST_HPP_
+#define CALLBACKS_BASE_TEST_HPP_
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <rmw_microxrcedds_c/config.h>
+
+extern "C"
+{
+#include "./types.h"
+#include "./callbacks.h"
+}
+
+#define BENCHMARK_MAX_READERS 256
+#define BENCHMARK_SAMPLES     100000
+#define BENCHMARK_PAYLOAD     32
+
+typedef struct
+{
+  uint8_t data[RMW_UXRCE_MAX_INPUT_BUFFER_SIZE];
+  size_t size;
+} benchmark_message_t;
+
+static rmw_context_impl_t benchmark_context;
+static rmw_uxrce_subscription_t benchmark_subscriptions[BENCHMARK_MAX_READERS];
+static uint32_t benchmark_occupancy[RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(BENCHMARK_MAX_READERS)];
+static rmw_uxrce_arena_unit_t benchmark_static_buffers[RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS];
+static rmw_uxrce_entity_table_entry_t benchmark_table_entries[BENCHMARK_MAX_READERS];
+
+class TestCallbacks : public ::testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    // Pools are set up by hand so that no agent is needed to drive the callbacks
+    rmw_uxrce_init_subscription_memory(
+      &subscription_memory, benchmark_subscriptions, benchmark_occupancy, BENCHMARK_MAX_READERS);
+    rmw_uxrce_init_static_input_buffer_memory(
+      &static_buffer_memory, benchmark_static_buffers, RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS);
+  }
+
+  void SetUp() override
+  {
+    benchmark_context.id_datareader = 0;
+    rmw_uxrce_init_entity_table(
+      &benchmark_context.subscription_table, benchmark_table_entries, BENCHMARK_MAX_READERS);
+  }
+
+  void TearDown() override
+  {
+    rmw_uxrce_mempool_cursor_t cursor;
+    rmw_uxrce_mempool_item_t * item = NULL;
+    while ((item = first_memory(&subscription_memory, &cursor)) != NULL) {
+      // Lock-free queues give their rings back to the arena
+      rmw_uxrce_subscription_t * subscription =
+        reinterpret_cast<rmw_uxrce_subscription_t *>(item->data);
+      rmw_uxrce_input_queue_fini(&subscription->input_queue);
+      put_memory(&subscription_memory, item);
+    }
+  }
+
+  rmw_uxrce_subscription_t * create_readers(
+    size_t count,
+    bool use_table)
+  {
+    // The last reader is walked last by the pool: worst case for a linear scan
+    rmw_uxrce_subscription_t * last = NULL;
+    for (size_t i = 0; i < count; i++) {
+      rmw_uxrce_mempool_item_t * item = get_memory(&subscription_memory);
+      EXPECT_NE(item, nullptr);
+      last = reinterpret_cast<rmw_uxrce_subscription_t *>(item->data);
+      rmw_uxrce_input_queue_init(&last->input_queue);
+      last->datareader_id = rmw_uxrce_entity_table_next_id(
+        &benchmark_context.subscription_table, &benchmark_context.id_datareader,
+        UXR_DATAREADER_ID);
+      if (use_table) {
+        rmw_uxrce_entity_table_insert(
+          &benchmark_context.subscription_table, last->datareader_id, last);
+      } else {
+        // Not indexed: on_topic has to walk the allocated subscriptions
+        benchmark_context.subscription_table.overflow++;
+      }
+    }
+    return last;
+  }
+
+  double dispatch_ns_per_sample(
+    rmw_uxrce_subscription_t * target)
+  {
+    uint8_t payload[BENCHMARK_PAYLOAD] = {0};
+    ucdrBuffer ub;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCHMARK_SAMPLES; i++) {
+      ucdr_init_buffer(&ub, payload, sizeof(payload));
+      on_topic(
+        &benchmark_context.session, target->datareader_id, 0,
+        benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+
+      rmw_uxrce_static_input_buffer_t * static_buffer =
+        rmw_uxrce_input_queue_pop(&target->input_queue);
+      if (static_buffer == NULL || static_buffer->owner != target) {
+        return -1.0;
+      }
+      rmw_uxrce_put_static_input_buffer(static_buffer);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / BENCHMARK_SAMPLES;
+  }
+};
+
+#endif  // CALLBACKS_BASE_TEST_HPP_
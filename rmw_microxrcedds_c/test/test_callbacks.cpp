@@ -0,0 +1,402 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <rmw/allocators.h>
+#include <rmw/error_handling.h>
+#include <rmw/rmw.h>
+#include <rmw_microros/rmw_microros.h>
+
+#include "./callbacks_base_test.hpp"
+
+static bool failing_deserialize(
+  ucdrBuffer * cdr,
+  void * untyped_ros_message)
+{
+  (void)cdr;
+  (void)untyped_ros_message;
+  return false;
+}
+
+static bool copying_deserialize(
+  ucdrBuffer * cdr,
+  void * untyped_ros_message)
+{
+  benchmark_message_t * ros_message = reinterpret_cast<benchmark_message_t *>(untyped_ros_message);
+  ros_message->size = ucdr_buffer_remaining(cdr);
+  return ucdr_deserialize_array_uint8_t(cdr, ros_message->data, ros_message->size);
+}
+
+/*
+ * Testing that entity ids never collide in the dispatch table while it has room.
+ */
+TEST_F(TestCallbacks, table_ids_do_not_collide)
+{
+  rmw_uxrce_subscription_t * subscription = create_readers(BENCHMARK_MAX_READERS, true);
+  ASSERT_EQ(benchmark_context.subscription_table.overflow, 0u);
+
+  rmw_uxrce_entity_table_remove(
+    &benchmark_context.subscription_table, subscription->datareader_id, subscription);
+  ASSERT_EQ(
+    rmw_uxrce_entity_table_find(
+      &benchmark_context.subscription_table, subscription->datareader_id), nullptr);
+
+  uxrObjectId id = rmw_uxrce_entity_table_next_id(
+    &benchmark_context.subscription_table, &benchmark_context.id_datareader,
+    UXR_DATAREADER_ID);
+  rmw_uxrce_entity_table_insert(&benchmark_context.subscription_table, id, subscription);
+  ASSERT_EQ(benchmark_context.subscription_table.overflow, 0u);
+  ASSERT_EQ(rmw_uxrce_entity_table_find(&benchmark_context.subscription_table, id), subscription);
+}
+
+/*
+ * Testing that a table sized for no entities sends every entity to the overflow.
+ */
+TEST_F(TestCallbacks, empty_table_overflows)
+{
+  rmw_uxrce_entity_table_t table;
+  rmw_uxrce_init_entity_table(&table, benchmark_table_entries, 0);
+
+  uint16_t id_counter = 0;
+  uxrObjectId id = rmw_uxrce_entity_table_next_id(&table, &id_counter, UXR_DATAREADER_ID);
+  rmw_uxrce_entity_table_insert(&table, id, benchmark_subscriptions);
+  ASSERT_EQ(table.overflow, 1u);
+  ASSERT_EQ(rmw_uxrce_entity_table_find(&table, id), nullptr);
+
+  rmw_uxrce_entity_table_remove(&table, id, benchmark_subscriptions);
+  ASSERT_EQ(table.overflow, 0u);
+}
+
+/*
+ * Testing that samples are queued per reader and taken oldest first.
+ */
+TEST_F(TestCallbacks, samples_are_taken_in_order)
+{
+  rmw_uxrce_subscription_t * second = create_readers(2, true);
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_subscription_t * first = reinterpret_cast<rmw_uxrce_subscription_t *>(
+    first_memory(&subscription_memory, &cursor)->data);
+  ucdrBuffer ub;
+
+  for (uint8_t i = 0; i < 3; i++) {
+    rmw_uxrce_subscription_t * target = (i % 2) ? second : first;
+    ucdr_init_buffer(&ub, &i, sizeof(i));
+    on_topic(
+      &benchmark_context.session, target->datareader_id, 0,
+      benchmark_context.best_effort_input, &ub, sizeof(i), &benchmark_context);
+  }
+
+  ASSERT_EQ(rmw_uxrce_input_queue_count(&first->input_queue), 2u);
+  ASSERT_EQ(rmw_uxrce_input_queue_count(&second->input_queue), 1u);
+
+  const uint8_t expected[] = {0, 2};
+  for (uint8_t value : expected) {
+    rmw_uxrce_static_input_buffer_t * static_buffer =
+      rmw_uxrce_input_queue_pop(&first->input_queue);
+    ASSERT_NE(static_buffer, nullptr);
+    ASSERT_EQ(static_buffer->buffer[0], value);
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+  }
+  ASSERT_FALSE(rmw_uxrce_input_queue_has_data(&first->input_queue));
+
+  rmw_uxrce_input_queue_fini(&first->input_queue);
+  rmw_uxrce_input_queue_fini(&second->input_queue);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+}
+
+/*
+ * Testing that a KEEP_LAST reader evicts its own oldest samples and keeps the newest ones.
+ */
+TEST_F(TestCallbacks, keep_last_evicts_oldest)
+{
+  rmw_uxrce_subscription_t * reader = create_readers(1, true);
+  rmw_uxrce_input_queue_set_depth(&reader->input_queue, 2);
+  ucdrBuffer ub;
+
+  for (uint8_t i = 0; i < 3; i++) {
+    ucdr_init_buffer(&ub, &i, sizeof(i));
+    on_topic(
+      &benchmark_context.session, reader->datareader_id, 0,
+      benchmark_context.best_effort_input, &ub, sizeof(i), &benchmark_context);
+  }
+
+  ASSERT_EQ(rmw_uxrce_input_queue_count(&reader->input_queue), 2u);
+
+  const uint8_t expected[] = {1, 2};
+  for (uint8_t value : expected) {
+    rmw_uxrce_static_input_buffer_t * static_buffer =
+      rmw_uxrce_input_queue_pop(&reader->input_queue);
+    ASSERT_NE(static_buffer, nullptr);
+    ASSERT_EQ(static_buffer->buffer[0], value);
+    rmw_uxrce_put_static_input_buffer(static_buffer);
+  }
+
+  rmw_uxrce_input_queue_fini(&reader->input_queue);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+}
+
+/*
+ * Testing that a flooding KEEP_LAST reader does not starve the other readers.
+ */
+TEST_F(TestCallbacks, keep_last_does_not_starve_readers)
+{
+  rmw_uxrce_subscription_t * quiet = create_readers(2, true);
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_subscription_t * flooding = reinterpret_cast<rmw_uxrce_subscription_t *>(
+    first_memory(&subscription_memory, &cursor)->data);
+  rmw_uxrce_input_queue_set_depth(&flooding->input_queue, 1);
+  uint8_t payload[BENCHMARK_PAYLOAD] = {0};
+  ucdrBuffer ub;
+
+  for (size_t i = 0; i < 4 * RMW_UXRCE_MAX_HISTORY; i++) {
+    ucdr_init_buffer(&ub, payload, sizeof(payload));
+    on_topic(
+      &benchmark_context.session, flooding->datareader_id, 0,
+      benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+  }
+  ASSERT_EQ(rmw_uxrce_input_queue_count(&flooding->input_queue), 1u);
+
+  ucdr_init_buffer(&ub, payload, sizeof(payload));
+  on_topic(
+    &benchmark_context.session, quiet->datareader_id, 0,
+    benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+  ASSERT_EQ(rmw_uxrce_input_queue_count(&quiet->input_queue), 1u);
+
+  rmw_uxrce_input_queue_fini(&flooding->input_queue);
+  rmw_uxrce_input_queue_fini(&quiet->input_queue);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+}
+
+/*
+ * Testing that a sample failing zero-copy deserialization is queued and reported at take.
+ */
+TEST_F(TestCallbacks, zero_copy_failure_falls_back_to_queue)
+{
+  static benchmark_message_t message;
+  message_type_support_callbacks_t callbacks = {};
+  callbacks.cdr_deserialize = failing_deserialize;
+
+  rmw_uxrce_subscription_t * target = create_readers(1, true);
+  target->type_support_callbacks = &callbacks;
+  target->zero_copy_destination = NULL;
+  target->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+
+  rmw_subscription_t subscription = {};
+  subscription.implementation_identifier = rmw_get_implementation_identifier();
+  subscription.data = target;
+  ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, &message), RMW_RET_OK);
+
+  uint8_t payload[BENCHMARK_PAYLOAD] = {0};
+  ucdrBuffer ub;
+  ucdr_init_buffer(&ub, payload, sizeof(payload));
+  on_topic(
+    &benchmark_context.session, target->datareader_id, 0,
+    benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+
+  ASSERT_EQ(target->zero_copy_state, RMW_UXRCE_ZERO_COPY_LENT);
+  ASSERT_EQ(rmw_uxrce_input_queue_count(&target->input_queue), 1u);
+
+  bool taken = false;
+  ASSERT_EQ(rmw_take(&subscription, &message, &taken, NULL), RMW_RET_ERROR);
+  rmw_reset_error();
+  ASSERT_FALSE(taken);
+
+  ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, NULL), RMW_RET_OK);
+  rmw_uxrce_input_queue_fini(&target->input_queue);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+}
+
+/*
+ * Testing that wait set readiness bits follow samples as they land and are taken.
+ */
+TEST_F(TestCallbacks, wait_set_readiness_bits)
+{
+  rmw_uxrce_subscription_t * second = create_readers(2, true);
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_subscription_t * first = reinterpret_cast<rmw_uxrce_subscription_t *>(
+    first_memory(&subscription_memory, &cursor)->data);
+  first->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+  second->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+
+  rmw_wait_set_t * wait_set = rmw_create_wait_set(NULL, 0);
+  ASSERT_NE(wait_set, nullptr);
+  rmw_uxrce_wait_set_t * custom_wait_set = reinterpret_cast<rmw_uxrce_wait_set_t *>(wait_set->data);
+
+  void * entities[2] = {first, second};
+  rmw_subscriptions_t subscriptions;
+  subscriptions.subscribers = entities;
+  subscriptions.subscriber_count = 2;
+  ASSERT_TRUE(rmw_uxrce_wait_set_register(custom_wait_set, &subscriptions, NULL, NULL));
+
+  ASSERT_FALSE(rmw_uxrce_wait_set_is_ready(custom_wait_set));
+
+  uint8_t payload = 0;
+  ucdrBuffer ub;
+  ucdr_init_buffer(&ub, &payload, sizeof(payload));
+  on_topic(
+    &benchmark_context.session, second->datareader_id, 0,
+    benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+
+  ASSERT_TRUE(rmw_uxrce_wait_set_is_ready(custom_wait_set));
+  ASSERT_EQ(custom_wait_set->ready[0], 2u);
+
+  rmw_time_t timeout = {0, 0};
+  ASSERT_EQ(rmw_wait(&subscriptions, NULL, NULL, NULL, NULL, wait_set, &timeout), RMW_RET_OK);
+  ASSERT_EQ(entities[0], nullptr);
+  ASSERT_EQ(entities[1], second);
+
+  rmw_uxrce_input_queue_flush(&second->input_queue);
+  ASSERT_FALSE(rmw_uxrce_wait_set_is_ready(custom_wait_set));
+
+  ASSERT_EQ(rmw_destroy_wait_set(wait_set), RMW_RET_OK);
+  ASSERT_EQ(second->input_queue.ready.word, nullptr);
+}
+
+/*
+ * Testing that a zero-copy destination is not written while the user holds it.
+ */
+TEST_F(TestCallbacks, zero_copy_destination_ownership)
+{
+  static benchmark_message_t destination;
+  static benchmark_message_t other;
+  message_type_support_callbacks_t callbacks = {};
+  callbacks.cdr_deserialize = copying_deserialize;
+
+  rmw_uxrce_subscription_t * target = create_readers(1, true);
+  target->type_support_callbacks = &callbacks;
+  target->zero_copy_destination = NULL;
+  target->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+
+  rmw_subscription_t subscription = {};
+  subscription.implementation_identifier = rmw_get_implementation_identifier();
+  subscription.data = target;
+  ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, &destination), RMW_RET_OK);
+
+  auto receive = [&](uint8_t value) {
+      uint8_t payload[BENCHMARK_PAYLOAD] = {value};
+      ucdrBuffer ub;
+      ucdr_init_buffer(&ub, payload, sizeof(payload));
+      on_topic(
+        &benchmark_context.session, target->datareader_id, 0,
+        benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+    };
+
+  // The first sample is written into the lent destination, the take hands it back
+  receive(1);
+  ASSERT_EQ(target->zero_copy_state, RMW_UXRCE_ZERO_COPY_PENDING);
+  bool taken = false;
+  ASSERT_EQ(rmw_take(&subscription, &destination, &taken, NULL), RMW_RET_OK);
+  ASSERT_TRUE(taken);
+  ASSERT_EQ(target->zero_copy_state, RMW_UXRCE_ZERO_COPY_HELD);
+
+  // While the user holds it, samples are queued and the destination is left untouched
+  receive(2);
+  ASSERT_EQ(destination.data[0], 1u);
+  ASSERT_EQ(rmw_uxrce_input_queue_count(&target->input_queue), 1u);
+
+  ASSERT_EQ(rmw_take(&subscription, &destination, &taken, NULL), RMW_RET_OK);
+  ASSERT_TRUE(taken);
+  ASSERT_EQ(destination.data[0], 2u);
+
+  // Lending it again brings zero-copy back
+  ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, &destination), RMW_RET_OK);
+  receive(3);
+  ASSERT_EQ(target->zero_copy_state, RMW_UXRCE_ZERO_COPY_PENDING);
+  ASSERT_EQ(destination.data[0], 3u);
+
+  // Sequences not starting with the destination take the queued samples through a copy
+  receive(4);
+  void * messages[1] = {&other};
+  rmw_message_info_t message_infos[1];
+  rmw_message_sequence_t message_sequence = rmw_get_zero_initialized_message_sequence();
+  message_sequence.data = messages;
+  message_sequence.capacity = 1;
+  rmw_message_info_sequence_t message_info_sequence =
+    rmw_get_zero_initialized_message_info_sequence();
+  message_info_sequence.data = message_infos;
+  message_info_sequence.capacity = 1;
+
+  size_t sequence_taken = 0;
+  ASSERT_EQ(
+    rmw_take_sequence(
+      &subscription, 1, &message_sequence, &message_info_sequence, &sequence_taken, NULL),
+    RMW_RET_OK);
+  ASSERT_EQ(sequence_taken, 1u);
+  ASSERT_EQ(other.data[0], 4u);
+  ASSERT_EQ(target->zero_copy_state, RMW_UXRCE_ZERO_COPY_PENDING);
+
+  ASSERT_EQ(rmw_take(&subscription, &destination, &taken, NULL), RMW_RET_OK);
+  ASSERT_TRUE(taken);
+  ASSERT_EQ(destination.data[0], 3u);
+
+  // A take into the destination that finds nothing lends it again
+  ASSERT_EQ(rmw_take(&subscription, &destination, &taken, NULL), RMW_RET_ERROR);
+  ASSERT_FALSE(taken);
+  ASSERT_EQ(target->zero_copy_state, RMW_UXRCE_ZERO_COPY_LENT);
+
+  ASSERT_EQ(rmw_uros_set_zero_copy_destination(&subscription, NULL), RMW_RET_OK);
+  rmw_uxrce_input_queue_fini(&target->input_queue);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+}
+
+/*
+ * Testing that a wait set outliving one of its entities is unregistered without touching it.
+ */
+TEST_F(TestCallbacks, wait_set_outlives_entity)
+{
+  rmw_uxrce_subscription_t * second = create_readers(2, true);
+  rmw_uxrce_mempool_cursor_t cursor;
+  rmw_uxrce_subscription_t * first = reinterpret_cast<rmw_uxrce_subscription_t *>(
+    first_memory(&subscription_memory, &cursor)->data);
+  first->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+  second->zero_copy_state = RMW_UXRCE_ZERO_COPY_HELD;
+
+  rmw_wait_set_t * wait_set = rmw_create_wait_set(NULL, 0);
+  ASSERT_NE(wait_set, nullptr);
+  rmw_uxrce_wait_set_t * custom_wait_set = reinterpret_cast<rmw_uxrce_wait_set_t *>(wait_set->data);
+
+  void * entities[2] = {first, second};
+  rmw_subscriptions_t subscriptions;
+  subscriptions.subscribers = entities;
+  subscriptions.subscriber_count = 2;
+  ASSERT_TRUE(rmw_uxrce_wait_set_register(custom_wait_set, &subscriptions, NULL, NULL));
+
+  uint8_t payload = 0;
+  ucdrBuffer ub;
+  ucdr_init_buffer(&ub, &payload, sizeof(payload));
+  on_topic(
+    &benchmark_context.session, first->datareader_id, 0,
+    benchmark_context.best_effort_input, &ub, sizeof(payload), &benchmark_context);
+  ASSERT_TRUE(rmw_uxrce_wait_set_is_ready(custom_wait_set));
+
+  // Finalizing the entity detaches it from the wait set
+  rmw_subscription_t * subscription =
+    reinterpret_cast<rmw_subscription_t *>(rmw_allocate(sizeof(rmw_subscription_t)));
+  ASSERT_NE(subscription, nullptr);
+  memset(subscription, 0, sizeof(rmw_subscription_t));
+  subscription->implementation_identifier = rmw_get_implementation_identifier();
+  subscription->data = first;
+  rmw_uxrce_fini_subscription_memory(subscription);
+
+  ASSERT_EQ(first->input_queue.ready.word, nullptr);
+  ASSERT_FALSE(rmw_uxrce_wait_set_is_ready(custom_wait_set));
+  ASSERT_NE(second->input_queue.ready.word, nullptr);
+
+  ASSERT_EQ(rmw_destroy_wait_set(wait_set), RMW_RET_OK);
+  ASSERT_EQ(second->input_queue.ready.word, nullptr);
+  ASSERT_EQ(static_buffer_memory.used, 0u);
+}
@@ -0,0 +1,98 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <rmw/error_handling.h>
+#include <rmw/rmw.h>
+#include <rmw_microxrcedds_c/config.h>
+#include <rmw_microros/rmw_microros.h>
+
+#include "./test_utils.hpp"
+
+// Pools are set up once per process, so this fixture must not share a binary with RMWBaseTest
+class TestMemoryArena : public ::testing::Test
+{
+protected:
+  rmw_context_t test_context = rmw_get_zero_initialized_context();
+  rmw_init_options_t test_options = rmw_get_zero_initialized_init_options();
+};
+
+/*
+ * Testing that pools are carved from the user arena with the requested sizes.
+ */
+TEST_F(TestMemoryArena, pools_from_arena)
+{
+  rmw_uros_memory_arena_counts_t counts = {};
+  counts.sessions = 1;
+  counts.nodes = 2;
+  counts.publishers = 1;
+  counts.subscriptions = 1;
+  counts.history = 2;
+
+  size_t size = rmw_uros_memory_arena_size(&counts);
+  ASSERT_GT(size, 0u);
+  std::vector<uint64_t> arena((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  uint8_t * begin = reinterpret_cast<uint8_t *>(arena.data());
+
+  ASSERT_EQ(rmw_init_options_init(&test_options, rcutils_get_default_allocator()), RMW_RET_OK);
+
+  // Too small or misaligned arenas are rejected
+  ASSERT_EQ(
+    rmw_uros_init_options_set_memory_arena(begin, size - 1, &counts, &test_options),
+    RMW_RET_INVALID_ARGUMENT);
+  rcutils_reset_error();
+  ASSERT_EQ(
+    rmw_uros_init_options_set_memory_arena(begin + 1, size - 1, &counts, &test_options),
+    RMW_RET_INVALID_ARGUMENT);
+  rcutils_reset_error();
+
+  ASSERT_EQ(
+    rmw_uros_init_options_set_memory_arena(begin, size, &counts, &test_options), RMW_RET_OK);
+  ASSERT_EQ(rmw_init(&test_options, &test_context), RMW_RET_OK);
+
+  rmw_uros_memory_statistics_t statistics;
+  ASSERT_EQ(
+    rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_NODES, &statistics), RMW_RET_OK);
+  ASSERT_EQ(statistics.capacity, counts.nodes);
+  ASSERT_EQ(
+    rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_TOPICS, &statistics), RMW_RET_OK);
+  ASSERT_EQ(statistics.capacity, counts.publishers + counts.subscriptions);
+  ASSERT_EQ(
+    rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_SERVICES, &statistics), RMW_RET_OK);
+  ASSERT_EQ(statistics.capacity, 0u);
+
+  std::vector<rmw_node_t *> nodes;
+  for (size_t i = 0; i < counts.nodes; i++) {
+    rmw_node_t * node = rmw_create_node(&test_context, "my_node", "/ns");
+    ASSERT_NE(node, nullptr);
+    ASSERT_GE(reinterpret_cast<uint8_t *>(node->data), begin);
+    ASSERT_LT(reinterpret_cast<uint8_t *>(node->data), begin + size);
+    nodes.push_back(node);
+  }
+
+#ifndef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
+  ASSERT_EQ(rmw_create_node(&test_context, "my_node", "/ns"), nullptr);
+  rcutils_reset_error();
+#endif  // RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
+
+  for (rmw_node_t * node : nodes) {
+    ASSERT_EQ(rmw_destroy_node(node), RMW_RET_OK);
+  }
+
+  ASSERT_EQ(rmw_shutdown(&test_context), RMW_RET_OK);
+  ASSERT_EQ(rmw_init_options_fini(&test_options), RMW_RET_OK);
+}
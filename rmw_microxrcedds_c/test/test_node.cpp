@@ -17,6 +17,7 @@
 #include <rmw/validate_namespace.h>
 #include <rmw/validate_node_name.h>
 #include <rmw_microxrcedds_c/config.h>
+#include <rmw_microros/rmw_microros.h>
 
 #include <vector>
 #include <memory>
@@ -111,3 +112,58 @@ TEST_F(TestNode, memory_poll)
 
   nodes.clear();
 }
+
+/*
+ * Testing node pool statistics
+ */
+TEST_F(TestNode, memory_statistics)
+{
+  std::vector<rmw_node_t *> nodes;
+  rmw_uros_memory_statistics_t statistics;
+
+  ASSERT_EQ(
+    rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_NODES, &statistics), RMW_RET_OK);
+  ASSERT_EQ(statistics.used, 0u);
+  ASSERT_GE(statistics.capacity, static_cast<size_t>(RMW_UXRCE_MAX_NODES));
+  size_t dynamic_allocations = statistics.dynamic_allocations;
+
+  // Fill the static pool
+  for (size_t i = 0; i < RMW_UXRCE_MAX_NODES; i++) {
+    rmw_node_t * node = rmw_create_node(&test_context, "my_node", "/ns");
+    ASSERT_NE(node, nullptr);
+    nodes.push_back(node);
+  }
+
+  ASSERT_EQ(
+    rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_NODES, &statistics), RMW_RET_OK);
+  ASSERT_EQ(statistics.used, static_cast<size_t>(RMW_UXRCE_MAX_NODES));
+  ASSERT_GE(statistics.high_water, static_cast<size_t>(RMW_UXRCE_MAX_NODES));
+
+#ifdef RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
+  // Growing allocates a whole chunk, which is kept for reuse once released
+  for (size_t i = 0; i < 2; i++) {
+    rmw_node_t * node = rmw_create_node(&test_context, "my_node", "/ns");
+    ASSERT_NE(node, nullptr);
+    ASSERT_EQ(
+      rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_NODES, &statistics), RMW_RET_OK);
+    ASSERT_EQ(statistics.dynamic_allocations, dynamic_allocations + 1);
+    ASSERT_EQ(rmw_destroy_node(node), RMW_RET_OK);
+  }
+#else
+  ASSERT_EQ(statistics.dynamic_allocations, dynamic_allocations);
+#endif  // RMW_UXRCE_ALLOW_DYNAMIC_ALLOCATIONS
+
+  for (size_t i = 0; i < nodes.size(); i++) {
+    ASSERT_EQ(rmw_destroy_node(nodes.at(i)), RMW_RET_OK);
+  }
+  nodes.clear();
+
+  ASSERT_EQ(
+    rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_NODES, &statistics), RMW_RET_OK);
+  ASSERT_EQ(statistics.used, 0u);
+
+  ASSERT_EQ(
+    rmw_uros_get_memory_statistics(RMW_UROS_MEMORY_POOL_NODES, NULL),
+    RMW_RET_INVALID_ARGUMENT);
+  rcutils_reset_error();
+}
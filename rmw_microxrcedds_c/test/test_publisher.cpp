@@ -26,9 +26,12 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <chrono>
+#include <thread>
 
 #include "./rmw_base_test.hpp"
 #include "./test_utils.hpp"
+#include "./types.h"
 
 class TestPublisher : public RMWBaseTest
 {
@@ -275,6 +278,63 @@ TEST_F(TestPublisher, memory_poll_shared_topic)
   }
 }
 
+/*
+ * Testing the XRCE publisher shared by the datawriters of a node
+ */
+TEST_F(TestPublisher, shared_node_publisher)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  rmw_uxrce_node_t * custom_node = reinterpret_cast<rmw_uxrce_node_t *>(this->node->data);
+  ASSERT_EQ(custom_node->publisher_users, 0u);
+
+  rmw_publisher_t * first = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)first, (void *)NULL);
+
+  rmw_publisher_t * second = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)second, (void *)NULL);
+  ASSERT_EQ(custom_node->publisher_users, 2u);
+
+  rmw_uxrce_publisher_t * first_impl = reinterpret_cast<rmw_uxrce_publisher_t *>(first->data);
+  rmw_uxrce_publisher_t * second_impl = reinterpret_cast<rmw_uxrce_publisher_t *>(second->data);
+  ASSERT_EQ(first_impl->publisher_id.id, second_impl->publisher_id.id);
+  ASSERT_NE(first_impl->datawriter_id.id, second_impl->datawriter_id.id);
+  ASSERT_EQ(first_impl->topic, second_impl->topic);
+
+  // Publishers sharing the XRCE publisher keep their own identity
+  rmw_gid_t first_gid, second_gid;
+  ASSERT_EQ(rmw_get_gid_for_publisher(first, &first_gid), RMW_RET_OK);
+  ASSERT_EQ(rmw_get_gid_for_publisher(second, &second_gid), RMW_RET_OK);
+  ASSERT_NE(memcmp(first_gid.data, second_gid.data, RMW_GID_STORAGE_SIZE), 0);
+
+  ASSERT_EQ(rmw_destroy_publisher(this->node, first), RMW_RET_OK);
+  ASSERT_EQ(custom_node->publisher_users, 1u);
+  ASSERT_EQ(rmw_destroy_publisher(this->node, second), RMW_RET_OK);
+  ASSERT_EQ(custom_node->publisher_users, 0u);
+}
+
 /*
  * Testing continous fragment mode without setting the custom callbacks
  */
@@ -409,3 +469,704 @@ TEST_F(TestPublisher, continous_fragment_mode_with_callbacks)
   ret = rmw_destroy_publisher(this->node, pub);
   ASSERT_EQ(ret, RMW_RET_OK);
 }
+
+/*
+ * Testing loaned messages lifecycle and publish throughput against rmw_publish
+ */
+
+typedef struct
+{
+  char data[64];
+} fixed_message_t;
+
+TEST_F(TestPublisher, loaned_messages)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  dummy_type_support.callbacks.cdr_serialize =
+    [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+    {
+      const fixed_message_t * ros_message =
+        reinterpret_cast<const fixed_message_t *>(untyped_ros_message);
+
+      return ucdr_serialize_array_char(cdr, ros_message->data, sizeof(ros_message->data));
+    };
+
+  dummy_type_support.callbacks.get_serialized_size = [](const void *)
+    {
+      return uint32_t(sizeof(fixed_message_t));
+    };
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  rmw_publisher_t * pub = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)pub, (void *)NULL);
+
+  // Loans are not available until a pool is set
+  void * loaned_message = NULL;
+  ASSERT_FALSE(pub->can_loan_messages);
+  ASSERT_EQ(
+    rmw_borrow_loaned_message(pub, &dummy_type_support.type_support, &loaned_message),
+    RMW_RET_UNSUPPORTED);
+  rmw_reset_error();
+
+  fixed_message_t loan_pool[2];
+  ASSERT_EQ(
+    rmw_uros_set_publisher_loan_pool(pub, loan_pool, sizeof(fixed_message_t), 2),
+    RMW_RET_OK);
+  ASSERT_TRUE(pub->can_loan_messages);
+
+  // Loans are only handed out for the type of the publisher
+  dummy_type_support_t other_type_support;
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &other_type_support);
+  ASSERT_EQ(
+    rmw_borrow_loaned_message(pub, &other_type_support.type_support, &loaned_message),
+    RMW_RET_INVALID_ARGUMENT);
+  ASSERT_EQ(loaned_message, nullptr);
+  rmw_reset_error();
+
+  // Borrow the whole pool
+  void * first_loan = NULL;
+  void * second_loan = NULL;
+  ASSERT_EQ(
+    rmw_borrow_loaned_message(pub, &dummy_type_support.type_support, &first_loan),
+    RMW_RET_OK);
+  ASSERT_EQ(
+    rmw_borrow_loaned_message(pub, &dummy_type_support.type_support, &second_loan),
+    RMW_RET_OK);
+  ASSERT_NE(first_loan, second_loan);
+  ASSERT_EQ(
+    rmw_borrow_loaned_message(pub, &dummy_type_support.type_support, &loaned_message),
+    RMW_RET_ERROR);
+  ASSERT_EQ(CheckErrorState(), true);
+
+  // Pool cannot be replaced while lent
+  ASSERT_EQ(
+    rmw_uros_set_publisher_loan_pool(pub, NULL, 0, 0),
+    RMW_RET_ERROR);
+  rmw_reset_error();
+
+  // Give one back and publish the other
+  ASSERT_EQ(rmw_return_loaned_message_from_publisher(pub, first_loan), RMW_RET_OK);
+  ASSERT_EQ(
+    rmw_return_loaned_message_from_publisher(pub, first_loan),
+    RMW_RET_ERROR);
+  rmw_reset_error();
+
+  memset(second_loan, 'A', sizeof(fixed_message_t));
+  ASSERT_EQ(rmw_publish_loaned_message(pub, second_loan, NULL), RMW_RET_OK);
+  ASSERT_EQ(rmw_publish_loaned_message(pub, second_loan, NULL), RMW_RET_ERROR);
+  rmw_reset_error();
+
+  // Throughput
+  const size_t iterations = 1000;
+  fixed_message_t ros_message;
+  memset(&ros_message, 'B', sizeof(ros_message));
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+  }
+  double regular_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    loaned_message = NULL;
+    ASSERT_EQ(
+      rmw_borrow_loaned_message(pub, &dummy_type_support.type_support, &loaned_message),
+      RMW_RET_OK);
+    memset(loaned_message, 'B', sizeof(fixed_message_t));
+    ASSERT_EQ(rmw_publish_loaned_message(pub, loaned_message, NULL), RMW_RET_OK);
+  }
+  double loaned_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  fprintf(stderr, "| Publish | Throughput |\n");
+  fprintf(stderr, "| - | - |\n");
+  fprintf(stderr, "| Regular | %.0f msg/s |\n", iterations / regular_s);
+  fprintf(stderr, "| Loaned | %.0f msg/s |\n", iterations / loaned_s);
+
+  ASSERT_EQ(rmw_uros_set_publisher_loan_pool(pub, NULL, 0, 0), RMW_RET_OK);
+  ASSERT_FALSE(pub->can_loan_messages);
+
+  rmw_ret_t ret = rmw_destroy_publisher(this->node, pub);
+  ASSERT_EQ(ret, RMW_RET_OK);
+}
+
+/*
+ * Benchmarking packets and bytes on the wire for batched and unbatched publishing
+ */
+
+static bool (* transport_send_msg)(void *, const uint8_t *, size_t) = NULL;
+static size_t sent_packets = 0;
+static size_t sent_bytes = 0;
+
+static bool counting_send_msg(
+  void * instance,
+  const uint8_t * buf,
+  size_t len)
+{
+  sent_packets++;
+  sent_bytes += len;
+  return transport_send_msg(instance, buf, len);
+}
+
+TEST_F(TestPublisher, publish_batch)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  dummy_type_support.callbacks.cdr_serialize =
+    [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+    {
+      const fixed_message_t * ros_message =
+        reinterpret_cast<const fixed_message_t *>(untyped_ros_message);
+
+      return ucdr_serialize_array_char(cdr, ros_message->data, sizeof(ros_message->data));
+    };
+
+  dummy_type_support.callbacks.get_serialized_size = [](const void *)
+    {
+      return uint32_t(sizeof(fixed_message_t));
+    };
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+  dummy_qos_policies.reliability = RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT;
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  rmw_publisher_t * pub = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)pub, (void *)NULL);
+
+  // Batch cannot be nested nor closed twice
+  ASSERT_EQ(rmw_uros_begin_publish_batch(&test_context), RMW_RET_OK);
+  ASSERT_EQ(rmw_uros_begin_publish_batch(&test_context), RMW_RET_ERROR);
+  rmw_reset_error();
+  ASSERT_EQ(rmw_uros_end_publish_batch(&test_context), RMW_RET_OK);
+  ASSERT_EQ(rmw_uros_end_publish_batch(&test_context), RMW_RET_ERROR);
+  rmw_reset_error();
+
+  rmw_context_impl_t * context_impl = test_context.impl;
+  transport_send_msg = context_impl->transport.comm.send_msg;
+  context_impl->transport.comm.send_msg = counting_send_msg;
+
+  const size_t bursts = 100;
+  const size_t burst_size = 20;
+  fixed_message_t ros_message;
+  memset(&ros_message, 'A', sizeof(ros_message));
+
+  sent_packets = 0;
+  sent_bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < bursts; i++) {
+    for (size_t j = 0; j < burst_size; j++) {
+      ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+    }
+  }
+  double unbatched_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+  size_t unbatched_packets = sent_packets;
+  size_t unbatched_bytes = sent_bytes;
+
+  sent_packets = 0;
+  sent_bytes = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < bursts; i++) {
+    ASSERT_EQ(rmw_uros_begin_publish_batch(&test_context), RMW_RET_OK);
+    for (size_t j = 0; j < burst_size; j++) {
+      ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+    }
+    ASSERT_EQ(rmw_uros_end_publish_batch(&test_context), RMW_RET_OK);
+  }
+  double batched_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+  size_t batched_packets = sent_packets;
+  size_t batched_bytes = sent_bytes;
+
+  context_impl->transport.comm.send_msg = transport_send_msg;
+
+  fprintf(stderr, "| Publish | Packets | Bytes on the wire | Packets/s |\n");
+  fprintf(stderr, "| - | - | - | - |\n");
+  fprintf(
+    stderr, "| Unbatched | %zu | %zu B | %.0f |\n",
+    unbatched_packets, unbatched_bytes, unbatched_packets / unbatched_s);
+  fprintf(
+    stderr, "| Batched | %zu | %zu B | %.0f |\n",
+    batched_packets, batched_bytes, batched_packets / batched_s);
+
+  ASSERT_LT(batched_packets, unbatched_packets);
+
+  rmw_ret_t ret = rmw_destroy_publisher(this->node, pub);
+  ASSERT_EQ(ret, RMW_RET_OK);
+}
+
+/*
+ * Testing entity creation, whose requests are sent back to back
+ */
+TEST_F(TestPublisher, creation_round_trips)
+{
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  rmw_context_impl_t * context_impl = test_context.impl;
+  transport_send_msg = context_impl->transport.comm.send_msg;
+  context_impl->transport.comm.send_msg = counting_send_msg;
+
+  // Topic, publisher and datawriter requests for a publisher alone in its node
+  const size_t entities = 30;
+  size_t creation_packets = 0;
+  for (size_t i = 0; i < entities; i++) {
+    dummy_type_support_t dummy_type_support;
+    ConfigureDummyTypeSupport(
+      topic_type,
+      topic_type,
+      message_namespace,
+      id_gen++,
+      &dummy_type_support);
+
+    sent_packets = 0;
+    rmw_publisher_t * pub = rmw_create_publisher(
+      this->node,
+      &dummy_type_support.type_support,
+      dummy_type_support.topic_name.data(),
+      &dummy_qos_policies,
+      &default_publisher_options);
+    creation_packets += sent_packets;
+    ASSERT_NE((void *)pub, (void *)NULL);
+
+    ASSERT_EQ(rmw_destroy_publisher(this->node, pub), RMW_RET_OK);
+  }
+
+  // Single datawriter request, as topic and publisher are shared with an existing one
+  dummy_type_support_t shared_type_support;
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &shared_type_support);
+
+  rmw_publisher_t * shared_pub = rmw_create_publisher(
+    this->node,
+    &shared_type_support.type_support,
+    shared_type_support.topic_name.data(),
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)shared_pub, (void *)NULL);
+
+  size_t single_request_packets = 0;
+  for (size_t i = 0; i < entities; i++) {
+    sent_packets = 0;
+    rmw_publisher_t * pub = rmw_create_publisher(
+      this->node,
+      &shared_type_support.type_support,
+      shared_type_support.topic_name.data(),
+      &dummy_qos_policies,
+      &default_publisher_options);
+    single_request_packets += sent_packets;
+    ASSERT_NE((void *)pub, (void *)NULL);
+
+    ASSERT_EQ(rmw_destroy_publisher(this->node, pub), RMW_RET_OK);
+  }
+
+  context_impl->transport.comm.send_msg = transport_send_msg;
+
+  // Three requests awaited one by one would take three times the packets of a single one
+  ASSERT_GT(single_request_packets, 0u);
+  ASSERT_LT(creation_packets, 2 * single_request_packets);
+
+  ASSERT_EQ(rmw_destroy_publisher(this->node, shared_pub), RMW_RET_OK);
+}
+
+/*
+ * Testing deferred entity creation committed in a single burst
+ */
+TEST_F(TestPublisher, deferred_entities)
+{
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  ASSERT_EQ(rmw_uros_commit_entities(&test_context), RMW_RET_ERROR);
+  rmw_reset_error();
+
+  rmw_context_impl_t * context_impl = test_context.impl;
+  transport_send_msg = context_impl->transport.comm.send_msg;
+  context_impl->transport.comm.send_msg = counting_send_msg;
+
+  std::vector<dummy_type_support_t> dummy_type_supports(RMW_UXRCE_MAX_PUBLISHERS);
+  std::vector<rmw_publisher_t *> publishers;
+
+  // Publishers created one by one, each one awaited in its own round trip
+  sent_packets = 0;
+  for (size_t i = 0; i < dummy_type_supports.size(); i++) {
+    ConfigureDummyTypeSupport(
+      topic_type,
+      topic_type,
+      message_namespace,
+      id_gen++,
+      &dummy_type_supports[i]);
+
+    rmw_publisher_t * pub = rmw_create_publisher(
+      this->node,
+      &dummy_type_supports[i].type_support,
+      dummy_type_supports[i].topic_name.data(),
+      &dummy_qos_policies,
+      &default_publisher_options);
+    ASSERT_NE((void *)pub, (void *)NULL);
+    publishers.push_back(pub);
+  }
+  size_t sequential_packets = sent_packets;
+
+  for (auto pub : publishers) {
+    ASSERT_EQ(rmw_destroy_publisher(this->node, pub), RMW_RET_OK);
+  }
+  publishers.clear();
+
+  // Same publishers committed in a single burst
+  sent_packets = 0;
+  ASSERT_EQ(rmw_uros_defer_entities(&test_context), RMW_RET_OK);
+  ASSERT_EQ(rmw_uros_defer_entities(&test_context), RMW_RET_ERROR);
+  rmw_reset_error();
+  for (size_t i = 0; i < dummy_type_supports.size(); i++) {
+    rmw_publisher_t * pub = rmw_create_publisher(
+      this->node,
+      &dummy_type_supports[i].type_support,
+      dummy_type_supports[i].topic_name.data(),
+      &dummy_qos_policies,
+      &default_publisher_options);
+    ASSERT_NE((void *)pub, (void *)NULL);
+    publishers.push_back(pub);
+  }
+  ASSERT_EQ(rmw_uros_commit_entities(&test_context), RMW_RET_OK);
+  size_t deferred_packets = sent_packets;
+
+  context_impl->transport.comm.send_msg = transport_send_msg;
+
+  // Requests of several entities share packets instead of one round trip per entity
+  ASSERT_GE(sequential_packets, dummy_type_supports.size());
+  ASSERT_LT(deferred_packets, sequential_packets);
+
+  fixed_message_t ros_message;
+  memset(&ros_message, 'A', sizeof(ros_message));
+  for (auto pub : publishers) {
+    ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+    ASSERT_EQ(rmw_destroy_publisher(this->node, pub), RMW_RET_OK);
+  }
+}
+
+/*
+ * Testing asynchronous reliable publishing and its in-flight accounting
+ */
+TEST_F(TestPublisher, async_reliable_publish)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  dummy_type_support.callbacks.cdr_serialize =
+    [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+    {
+      const fixed_message_t * ros_message =
+        reinterpret_cast<const fixed_message_t *>(untyped_ros_message);
+
+      return ucdr_serialize_array_char(cdr, ros_message->data, sizeof(ros_message->data));
+    };
+
+  dummy_type_support.callbacks.get_serialized_size = [](const void *)
+    {
+      return uint32_t(sizeof(fixed_message_t));
+    };
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+  dummy_qos_policies.reliability = RMW_QOS_POLICY_RELIABILITY_RELIABLE;
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  rmw_publisher_t * pub = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)pub, (void *)NULL);
+
+  const size_t iterations = 100;
+  fixed_message_t ros_message;
+  memset(&ros_message, 'A', sizeof(ros_message));
+
+  size_t in_flight_samples = 0;
+  size_t unacked_bytes = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+  }
+  double blocking_us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - start).count() / iterations;
+
+  ASSERT_EQ(rmw_uros_set_publisher_async_reliable(pub, true), RMW_RET_OK);
+
+  // A sample is in flight until the session runs and receives its acknowledgement,
+  // which the query itself may do
+  ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+  ASSERT_EQ(
+    rmw_uros_get_publisher_in_flight(pub, &in_flight_samples, &unacked_bytes),
+    RMW_RET_OK);
+  ASSERT_LE(in_flight_samples, 1u);
+  ASSERT_EQ(unacked_bytes, in_flight_samples * sizeof(fixed_message_t));
+
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+  }
+  double async_us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - start).count() / iterations;
+
+  rmw_guard_conditions_t guard_conditions;
+  guard_conditions.guard_condition_count = 0;
+  rmw_time_t wait_timeout;
+  wait_timeout.sec = 0;
+  wait_timeout.nsec = 100000000;
+
+  for (size_t i = 0; i < 50; i++) {
+    ASSERT_EQ(
+      rmw_uros_get_publisher_in_flight(pub, &in_flight_samples, &unacked_bytes),
+      RMW_RET_OK);
+    if (0 == in_flight_samples) {
+      break;
+    }
+    rmw_wait(NULL, &guard_conditions, NULL, NULL, NULL, NULL, &wait_timeout);
+  }
+  ASSERT_EQ(in_flight_samples, 0u);
+  ASSERT_EQ(unacked_bytes, 0u);
+
+  fprintf(stderr, "| Reliable publish | Mean time per sample |\n");
+  fprintf(stderr, "| - | - |\n");
+  fprintf(stderr, "| Blocking | %.1f us |\n", blocking_us);
+  fprintf(stderr, "| Asynchronous | %.1f us |\n", async_us);
+
+  rmw_ret_t ret = rmw_destroy_publisher(this->node, pub);
+  ASSERT_EQ(ret, RMW_RET_OK);
+}
+
+/*
+ * Testing publisher mapping onto output streams
+ */
+TEST_F(TestPublisher, output_streams)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  dummy_type_support.callbacks.cdr_serialize =
+    [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+    {
+      const fixed_message_t * ros_message =
+        reinterpret_cast<const fixed_message_t *>(untyped_ros_message);
+
+      return ucdr_serialize_array_char(cdr, ros_message->data, sizeof(ros_message->data));
+    };
+
+  dummy_type_support.callbacks.get_serialized_size = [](const void *)
+    {
+      return uint32_t(sizeof(fixed_message_t));
+    };
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+  dummy_qos_policies.reliability = RMW_QOS_POLICY_RELIABILITY_RELIABLE;
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  rmw_publisher_t * pub = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)pub, (void *)NULL);
+
+  ASSERT_EQ(
+    rmw_uros_set_publisher_output_stream(pub, RMW_UXRCE_RELIABLE_OUTPUT_STREAMS),
+    RMW_RET_INVALID_ARGUMENT);
+  rmw_reset_error();
+
+  fixed_message_t ros_message;
+  memset(&ros_message, 'A', sizeof(ros_message));
+
+  // Every stream delivers on its own
+  for (size_t i = 0; i < RMW_UXRCE_RELIABLE_OUTPUT_STREAMS; i++) {
+    ASSERT_EQ(rmw_uros_set_publisher_output_stream(pub, i), RMW_RET_OK);
+    ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+  }
+
+  rmw_ret_t ret = rmw_destroy_publisher(this->node, pub);
+  ASSERT_EQ(ret, RMW_RET_OK);
+}
+
+/*
+ * Testing priority class budgets over a throttled transport
+ */
+static bool throttled_send_msg(
+  void * instance,
+  const uint8_t * buf,
+  size_t len)
+{
+  // 115200 baud serial link, 10 bits per byte
+  std::this_thread::sleep_for(std::chrono::microseconds(len * 10 * 1000000 / 115200));
+  return transport_send_msg(instance, buf, len);
+}
+
+TEST_F(TestPublisher, priority_budget)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  dummy_type_support.callbacks.cdr_serialize =
+    [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+    {
+      const fixed_message_t * ros_message =
+        reinterpret_cast<const fixed_message_t *>(untyped_ros_message);
+
+      return ucdr_serialize_array_char(cdr, ros_message->data, sizeof(ros_message->data));
+    };
+
+  dummy_type_support.callbacks.get_serialized_size = [](const void *)
+    {
+      return uint32_t(sizeof(fixed_message_t));
+    };
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+  dummy_qos_policies.reliability = RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT;
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+
+  rmw_publisher_t * actuation = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)actuation, (void *)NULL);
+
+  rmw_publisher_t * telemetry = rmw_create_publisher(
+    this->node,
+    &dummy_type_support.type_support,
+    topic_name,
+    &dummy_qos_policies,
+    &default_publisher_options);
+  ASSERT_NE((void *)telemetry, (void *)NULL);
+
+  const size_t budget = 2000;
+  const size_t telemetry_priority = RMW_UXRCE_PRIORITY_CLASSES - 1;
+
+  ASSERT_EQ(
+    rmw_uros_set_publisher_priority(telemetry, RMW_UXRCE_PRIORITY_CLASSES),
+    RMW_RET_INVALID_ARGUMENT);
+  rmw_reset_error();
+  ASSERT_EQ(rmw_uros_set_publisher_priority(telemetry, telemetry_priority), RMW_RET_OK);
+  ASSERT_EQ(rmw_uros_set_priority_budget(&test_context, 0, 0), RMW_RET_OK);
+  ASSERT_EQ(
+    rmw_uros_set_priority_budget(&test_context, telemetry_priority, budget), RMW_RET_OK);
+
+  rmw_context_impl_t * context_impl = test_context.impl;
+  transport_send_msg = context_impl->transport.comm.send_msg;
+  context_impl->transport.comm.send_msg = throttled_send_msg;
+
+  fixed_message_t ros_message;
+  memset(&ros_message, 'A', sizeof(ros_message));
+
+  // Telemetry is published as fast as the link allows, actuation at a lower rate
+  size_t actuation_samples = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; std::chrono::steady_clock::now() - start < std::chrono::seconds(1); i++) {
+    ASSERT_EQ(rmw_publish(telemetry, &ros_message, NULL), RMW_RET_OK);
+    if (0 == i % 4) {
+      ASSERT_EQ(rmw_publish(actuation, &ros_message, NULL), RMW_RET_OK);
+      actuation_samples++;
+    }
+  }
+  double elapsed_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  context_impl->transport.comm.send_msg = transport_send_msg;
+
+  size_t actuation_bytes, actuation_dropped;
+  size_t telemetry_bytes, telemetry_dropped;
+  ASSERT_EQ(
+    rmw_uros_get_priority_usage(&test_context, 0, &actuation_bytes, &actuation_dropped),
+    RMW_RET_OK);
+  ASSERT_EQ(
+    rmw_uros_get_priority_usage(
+      &test_context, telemetry_priority, &telemetry_bytes, &telemetry_dropped),
+    RMW_RET_OK);
+
+  fprintf(stderr, "| Class | Sent | Dropped samples |\n");
+  fprintf(stderr, "| - | - | - |\n");
+  fprintf(stderr, "| Actuation | %zu B | %zu |\n", actuation_bytes, actuation_dropped);
+  fprintf(stderr, "| Telemetry | %zu B | %zu |\n", telemetry_bytes, telemetry_dropped);
+
+  // Actuation is never dropped, telemetry stays within its budget plus one burst
+  ASSERT_EQ(actuation_dropped, 0u);
+  ASSERT_EQ(actuation_bytes, actuation_samples * sizeof(fixed_message_t));
+  ASSERT_GT(telemetry_dropped, 0u);
+  ASSERT_LE(telemetry_bytes, budget * elapsed_s + budget / 10 + 2 * sizeof(fixed_message_t));
+
+  ASSERT_EQ(rmw_destroy_publisher(this->node, telemetry), RMW_RET_OK);
+  ASSERT_EQ(rmw_destroy_publisher(this->node, actuation), RMW_RET_OK);
+}
@@ -16,9 +16,11 @@
 #include <string>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
 #include "rmw/validate_namespace.h"
 #include "rmw/validate_node_name.h"
 
@@ -26,6 +28,7 @@
 #include "./test_utils.hpp"
 
 #include "rosidl_runtime_c/string.h"
+#include "rmw_microros/rmw_microros.h"
 
 #define MICROXRCEDDS_PADDING    sizeof(uint32_t)
 
@@ -38,6 +41,47 @@ protected:
   const char * topic_type = "topic_type";
   const char * topic_name = "topic_name";
   const char * message_namespace = "package_name";
+
+  void ConfigureStringTypeSupport(
+    dummy_type_support_t * dummy_type_support)
+  {
+    dummy_type_support->callbacks.cdr_serialize =
+      [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+      {
+        bool ret;
+        const rosidl_runtime_c__String * ros_message =
+          reinterpret_cast<const rosidl_runtime_c__String *>(untyped_ros_message);
+
+        ret = ucdr_serialize_string(cdr, ros_message->data);
+        return ret;
+      };
+    dummy_type_support->callbacks.cdr_deserialize =
+      [](ucdrBuffer * cdr, void * untyped_ros_message) -> bool
+      {
+        bool ret;
+        rosidl_runtime_c__String * ros_message =
+          reinterpret_cast<rosidl_runtime_c__String *>(untyped_ros_message);
+
+        ret = ucdr_deserialize_string(cdr, ros_message->data, ros_message->capacity);
+        if (ret) {
+          ros_message->size = strlen(ros_message->data);
+        }
+        return ret;
+      };
+    dummy_type_support->callbacks.get_serialized_size =
+      [](const void * untyped_ros_message) -> uint32_t
+      {
+        const rosidl_runtime_c__String * ros_message =
+          reinterpret_cast<const rosidl_runtime_c__String *>(untyped_ros_message);
+
+        return MICROXRCEDDS_PADDING + ucdr_alignment(0, MICROXRCEDDS_PADDING) +
+               ros_message->size + 8;
+      };
+    dummy_type_support->callbacks.max_serialized_size = []() -> size_t
+      {
+        return (size_t)(MICROXRCEDDS_PADDING + ucdr_alignment(0, MICROXRCEDDS_PADDING) + 1);
+      };
+  }
 };
 
 /*
@@ -54,41 +98,7 @@ TEST_F(TestPubSub, publish_and_receive)
     id_gen++,
     &dummy_type_support);
 
-  dummy_type_support.callbacks.cdr_serialize =
-    [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
-    {
-      bool ret;
-      const rosidl_runtime_c__String * ros_message =
-        reinterpret_cast<const rosidl_runtime_c__String *>(untyped_ros_message);
-
-      ret = ucdr_serialize_string(cdr, ros_message->data);
-      return ret;
-    };
-  dummy_type_support.callbacks.cdr_deserialize =
-    [](ucdrBuffer * cdr, void * untyped_ros_message) -> bool
-    {
-      bool ret;
-      rosidl_runtime_c__String * ros_message =
-        reinterpret_cast<rosidl_runtime_c__String *>(untyped_ros_message);
-
-      ret = ucdr_deserialize_string(cdr, ros_message->data, ros_message->capacity);
-      if (ret) {
-        ros_message->size = strlen(ros_message->data);
-      }
-      return ret;
-    };
-  dummy_type_support.callbacks.get_serialized_size =
-    [](const void * untyped_ros_message) -> uint32_t
-    {
-      const rosidl_runtime_c__String * ros_message =
-        reinterpret_cast<const rosidl_runtime_c__String *>(untyped_ros_message);
-
-      return MICROXRCEDDS_PADDING + ucdr_alignment(0, MICROXRCEDDS_PADDING) + ros_message->size + 8;
-    };
-  dummy_type_support.callbacks.max_serialized_size = []() -> size_t
-    {
-      return (size_t)(MICROXRCEDDS_PADDING + ucdr_alignment(0, MICROXRCEDDS_PADDING) + 1);
-    };
+  ConfigureStringTypeSupport(&dummy_type_support);
 
   rmw_qos_profile_t dummy_qos_policies;
   ConfigureDefaultQOSPolices(&dummy_qos_policies);
@@ -178,3 +188,371 @@ TEST_F(TestPubSub, publish_and_receive)
   ASSERT_EQ(strcmp(ros_message.data, read_ros_message.data), 0);
   ASSERT_EQ(ros_message.size, read_ros_message.size);
 }
+
+/*
+ * Benchmarking wake-up latency of rmw_wait, from publication to return.
+ */
+TEST_F(TestPubSub, wait_wake_up_latency)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  ConfigureStringTypeSupport(&dummy_type_support);
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_node_t * node = rmw_create_node(&test_context, "latency_node", "/ns");
+  ASSERT_NE((void *)node, (void *)NULL);
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+  rmw_publisher_t * pub = rmw_create_publisher(
+    node, &dummy_type_support.type_support,
+    topic_name, &dummy_qos_policies, &default_publisher_options);
+  ASSERT_NE((void *)pub, (void *)NULL);
+
+  rmw_subscription_options_t default_subscription_options = rmw_get_default_subscription_options();
+  rmw_subscription_t * sub = rmw_create_subscription(
+    node, &dummy_type_support.type_support,
+    topic_name, &dummy_qos_policies, &default_subscription_options);
+  ASSERT_NE((void *)sub, (void *)NULL);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  char content[] = "Latency message";
+  rosidl_runtime_c__String ros_message;
+  ros_message.data = content;
+  ros_message.capacity = strlen(ros_message.data);
+  ros_message.size = ros_message.capacity;
+
+  char buff[100];
+  rosidl_runtime_c__String read_ros_message;
+  read_ros_message.data = buff;
+  read_ros_message.capacity = sizeof(buff);
+  read_ros_message.size = 0;
+
+  rmw_subscriptions_t subscriptions;
+  rmw_guard_conditions_t guard_conditions;
+  guard_conditions.guard_condition_count = 0;
+  rmw_services_t services;
+  services.service_count = 0;
+  rmw_clients_t clients;
+  clients.client_count = 0;
+
+  rmw_time_t wait_timeout;
+  wait_timeout.sec = 1;
+  wait_timeout.nsec = 0;
+
+  const size_t iterations = 20;
+  std::vector<double> arrival_us;
+  std::vector<double> pending_us;
+
+  for (size_t i = 0; i < iterations; i++) {
+    // Sample arrives while rmw_wait is blocked
+    ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+    auto start = std::chrono::steady_clock::now();
+    void * subscriber = sub->data;
+    subscriptions.subscribers = &subscriber;
+    subscriptions.subscriber_count = 1;
+    ASSERT_EQ(
+      rmw_wait(
+        &subscriptions, &guard_conditions, &services, &clients, NULL, NULL,
+        &wait_timeout), RMW_RET_OK);
+    arrival_us.push_back(
+      std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count());
+
+    // Sample is already queued: no session run is needed
+    subscriber = sub->data;
+    start = std::chrono::steady_clock::now();
+    ASSERT_EQ(
+      rmw_wait(
+        &subscriptions, &guard_conditions, &services, &clients, NULL, NULL,
+        &wait_timeout), RMW_RET_OK);
+    pending_us.push_back(
+      std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count());
+
+    bool taken = false;
+    ASSERT_EQ(rmw_take_with_info(sub, &read_ros_message, &taken, NULL, NULL), RMW_RET_OK);
+    ASSERT_EQ(taken, true);
+  }
+
+  double arrival_mean = 0.0;
+  double pending_mean = 0.0;
+  for (size_t i = 0; i < iterations; i++) {
+    arrival_mean += arrival_us[i] / iterations;
+    pending_mean += pending_us[i] / iterations;
+  }
+
+  fprintf(stderr, "| Case | Mean wake-up latency |\n");
+  fprintf(stderr, "| - | - |\n");
+  fprintf(stderr, "| Sample arrival | %.1f us |\n", arrival_mean);
+  fprintf(stderr, "| Sample already queued | %.1f us |\n", pending_mean);
+}
+
+/*
+ * Testing loaned take of a fixed-size message from the static input buffers.
+ */
+
+typedef struct
+{
+  uint32_t sequence;
+  double values[16];
+} sensor_frame_t;
+
+TEST_F(TestPubSub, take_loaned_message)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  dummy_type_support.callbacks.cdr_serialize =
+    [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+    {
+      const sensor_frame_t * ros_message =
+        reinterpret_cast<const sensor_frame_t *>(untyped_ros_message);
+
+      bool ret = ucdr_serialize_uint32_t(cdr, ros_message->sequence);
+      ret &= ucdr_serialize_array_double(cdr, ros_message->values, 16);
+      return ret;
+    };
+  dummy_type_support.callbacks.cdr_deserialize =
+    [](ucdrBuffer * cdr, void * untyped_ros_message) -> bool
+    {
+      sensor_frame_t * ros_message = reinterpret_cast<sensor_frame_t *>(untyped_ros_message);
+
+      bool ret = ucdr_deserialize_uint32_t(cdr, &ros_message->sequence);
+      ret &= ucdr_deserialize_array_double(cdr, ros_message->values, 16);
+      return ret;
+    };
+  dummy_type_support.callbacks.get_serialized_size = [](const void *) -> uint32_t
+    {
+      return (uint32_t)(sizeof(uint32_t) + ucdr_alignment(sizeof(uint32_t), 8) +
+             16 * sizeof(double));
+    };
+  dummy_type_support.callbacks.max_serialized_size = []() -> size_t
+    {
+      return sizeof(uint32_t) + ucdr_alignment(sizeof(uint32_t), 8) + 16 * sizeof(double);
+    };
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_node_t * node = rmw_create_node(&test_context, "loan_node", "/ns");
+  ASSERT_NE((void *)node, (void *)NULL);
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+  rmw_publisher_t * pub = rmw_create_publisher(
+    node, &dummy_type_support.type_support,
+    topic_name, &dummy_qos_policies, &default_publisher_options);
+  ASSERT_NE((void *)pub, (void *)NULL);
+
+  rmw_subscription_options_t default_subscription_options = rmw_get_default_subscription_options();
+  rmw_subscription_t * sub = rmw_create_subscription(
+    node, &dummy_type_support.type_support,
+    topic_name, &dummy_qos_policies, &default_subscription_options);
+  ASSERT_NE((void *)sub, (void *)NULL);
+
+  ASSERT_FALSE(sub->can_loan_messages);
+  ASSERT_EQ(rmw_uros_set_subscription_loan_size(sub, sizeof(sensor_frame_t)), RMW_RET_OK);
+  ASSERT_TRUE(sub->can_loan_messages);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  sensor_frame_t ros_message;
+  ros_message.sequence = 42;
+  for (size_t i = 0; i < 16; i++) {
+    ros_message.values[i] = 0.5 * i;
+  }
+  ASSERT_EQ(rmw_publish(pub, &ros_message, NULL), RMW_RET_OK);
+
+  rmw_subscriptions_t subscriptions;
+  subscriptions.subscribers = &sub->data;
+  subscriptions.subscriber_count = 1;
+  rmw_guard_conditions_t guard_conditions;
+  guard_conditions.guard_condition_count = 0;
+  rmw_services_t services;
+  services.service_count = 0;
+  rmw_clients_t clients;
+  clients.client_count = 0;
+
+  rmw_time_t wait_timeout;
+  wait_timeout.sec = 1;
+  wait_timeout.nsec = 0;
+
+  ASSERT_EQ(
+    rmw_wait(
+      &subscriptions, &guard_conditions, &services, &clients, NULL, NULL,
+      &wait_timeout), RMW_RET_OK);
+  ASSERT_NE((void *)subscriptions.subscribers[0], (void *)NULL);
+
+  void * loaned_message = NULL;
+  bool taken = false;
+  ASSERT_EQ(rmw_take_loaned_message(sub, &loaned_message, &taken, NULL), RMW_RET_OK);
+  ASSERT_EQ(taken, true);
+  ASSERT_NE(loaned_message, (void *)NULL);
+
+  const sensor_frame_t * frame = reinterpret_cast<const sensor_frame_t *>(loaned_message);
+  ASSERT_EQ(frame->sequence, ros_message.sequence);
+  for (size_t i = 0; i < 16; i++) {
+    ASSERT_EQ(frame->values[i], ros_message.values[i]);
+  }
+
+  // Loan size cannot change while a message is lent
+  ASSERT_EQ(rmw_uros_set_subscription_loan_size(sub, 0), RMW_RET_ERROR);
+  rmw_reset_error();
+
+  ASSERT_EQ(rmw_return_loaned_message_from_subscription(sub, loaned_message), RMW_RET_OK);
+  ASSERT_EQ(
+    rmw_return_loaned_message_from_subscription(sub, loaned_message),
+    RMW_RET_ERROR);
+  rmw_reset_error();
+
+  ASSERT_EQ(rmw_uros_set_subscription_loan_size(sub, 0), RMW_RET_OK);
+  ASSERT_FALSE(sub->can_loan_messages);
+
+  ASSERT_EQ(rmw_destroy_subscription(node, sub), RMW_RET_OK);
+  ASSERT_EQ(rmw_destroy_publisher(node, pub), RMW_RET_OK);
+  ASSERT_EQ(rmw_destroy_node(node), RMW_RET_OK);
+}
+
+/*
+ * Testing and benchmarking a relay that forwards serialized messages between topics.
+ */
+TEST_F(TestPubSub, serialized_relay)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    message_namespace,
+    id_gen++,
+    &dummy_type_support);
+
+  ConfigureStringTypeSupport(&dummy_type_support);
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_node_t * node = rmw_create_node(&test_context, "relay_node", "/ns");
+  ASSERT_NE((void *)node, (void *)NULL);
+
+  rmw_publisher_options_t default_publisher_options = rmw_get_default_publisher_options();
+  rmw_subscription_options_t default_subscription_options = rmw_get_default_subscription_options();
+
+  // Source topic feeding the relay and relayed topic read back
+  rmw_publisher_t * source_pub = rmw_create_publisher(
+    node, &dummy_type_support.type_support,
+    "relay_source", &dummy_qos_policies, &default_publisher_options);
+  ASSERT_NE((void *)source_pub, (void *)NULL);
+  rmw_subscription_t * relay_sub = rmw_create_subscription(
+    node, &dummy_type_support.type_support,
+    "relay_source", &dummy_qos_policies, &default_subscription_options);
+  ASSERT_NE((void *)relay_sub, (void *)NULL);
+  rmw_publisher_t * relay_pub = rmw_create_publisher(
+    node, &dummy_type_support.type_support,
+    "relay_sink", &dummy_qos_policies, &default_publisher_options);
+  ASSERT_NE((void *)relay_pub, (void *)NULL);
+  rmw_subscription_t * sink_sub = rmw_create_subscription(
+    node, &dummy_type_support.type_support,
+    "relay_sink", &dummy_qos_policies, &default_subscription_options);
+  ASSERT_NE((void *)sink_sub, (void *)NULL);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  char content[] = "Relayed message";
+  rosidl_runtime_c__String ros_message;
+  ros_message.data = content;
+  ros_message.capacity = strlen(ros_message.data);
+  ros_message.size = ros_message.capacity;
+
+  char buff[100];
+  rosidl_runtime_c__String read_ros_message;
+  read_ros_message.data = buff;
+  read_ros_message.capacity = sizeof(buff);
+  read_ros_message.size = 0;
+
+  rmw_serialized_message_t serialized_message = rmw_get_zero_initialized_serialized_message();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(rmw_serialized_message_init(&serialized_message, 0, &allocator), RMW_RET_OK);
+
+  rmw_subscriptions_t subscriptions;
+  rmw_guard_conditions_t guard_conditions;
+  guard_conditions.guard_condition_count = 0;
+  rmw_services_t services;
+  services.service_count = 0;
+  rmw_clients_t clients;
+  clients.client_count = 0;
+
+  rmw_time_t wait_timeout;
+  wait_timeout.sec = 1;
+  wait_timeout.nsec = 0;
+
+  auto wait_for = [&](rmw_subscription_t * sub) -> rmw_ret_t
+    {
+      void * subscriber = sub->data;
+      subscriptions.subscribers = &subscriber;
+      subscriptions.subscriber_count = 1;
+      return rmw_wait(
+        &subscriptions, &guard_conditions, &services, &clients, NULL, NULL, &wait_timeout);
+    };
+
+  const size_t iterations = 100;
+  double typed_us = 0.0;
+  double serialized_us = 0.0;
+
+  for (size_t i = 0; i < iterations; i++) {
+    bool taken = false;
+
+    // Typed relay: deserialize and serialize again
+    ASSERT_EQ(rmw_publish(source_pub, &ros_message, NULL), RMW_RET_OK);
+    ASSERT_EQ(wait_for(relay_sub), RMW_RET_OK);
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(rmw_take(relay_sub, &read_ros_message, &taken, NULL), RMW_RET_OK);
+    ASSERT_EQ(taken, true);
+    ASSERT_EQ(rmw_publish(relay_pub, &read_ros_message, NULL), RMW_RET_OK);
+    typed_us += std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(wait_for(sink_sub), RMW_RET_OK);
+    ASSERT_EQ(rmw_take(sink_sub, &read_ros_message, &taken, NULL), RMW_RET_OK);
+    ASSERT_EQ(strcmp(content, read_ros_message.data), 0);
+
+    // Serialized relay: CDR payload is forwarded untouched
+    ASSERT_EQ(rmw_publish(source_pub, &ros_message, NULL), RMW_RET_OK);
+    ASSERT_EQ(wait_for(relay_sub), RMW_RET_OK);
+    start = std::chrono::steady_clock::now();
+    ASSERT_EQ(
+      rmw_take_serialized_message(relay_sub, &serialized_message, &taken, NULL),
+      RMW_RET_OK);
+    ASSERT_EQ(taken, true);
+    ASSERT_EQ(
+      rmw_publish_serialized_message(relay_pub, &serialized_message, NULL),
+      RMW_RET_OK);
+    serialized_us += std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(wait_for(sink_sub), RMW_RET_OK);
+    read_ros_message.size = 0;
+    ASSERT_EQ(rmw_take(sink_sub, &read_ros_message, &taken, NULL), RMW_RET_OK);
+    ASSERT_EQ(strcmp(content, read_ros_message.data), 0);
+  }
+
+  fprintf(stderr, "| Relay | Mean take and forward time |\n");
+  fprintf(stderr, "| - | - |\n");
+  fprintf(stderr, "| Typed | %.1f us |\n", typed_us / iterations);
+  fprintf(stderr, "| Serialized | %.1f us |\n", serialized_us / iterations);
+
+  ASSERT_EQ(rmw_serialized_message_fini(&serialized_message), RMW_RET_OK);
+}
@@ -0,0 +1,204 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <rmw/error_handling.h>
+#include <rmw/rmw.h>
+#include <rmw/serialized_message.h>
+#include <rcutils/allocator.h>
+#include <rosidl_runtime_c/string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "./test_utils.hpp"
+
+#define MICROXRCEDDS_PADDING    sizeof(uint32_t)
+#define MAX_STRING_SIZE         4096
+
+class TestSerialize : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ConfigureDummyTypeSupport(
+      "topic_type",
+      "topic_name",
+      "package_name",
+      0,
+      &dummy_type_support);
+
+    dummy_type_support.callbacks.cdr_serialize =
+      [](const void * untyped_ros_message, ucdrBuffer * cdr) -> bool
+      {
+        const rosidl_runtime_c__String * ros_message =
+          reinterpret_cast<const rosidl_runtime_c__String *>(untyped_ros_message);
+
+        return ucdr_serialize_string(cdr, ros_message->data);
+      };
+    dummy_type_support.callbacks.cdr_deserialize =
+      [](ucdrBuffer * cdr, void * untyped_ros_message) -> bool
+      {
+        rosidl_runtime_c__String * ros_message =
+          reinterpret_cast<rosidl_runtime_c__String *>(untyped_ros_message);
+
+        bool ret = ucdr_deserialize_string(cdr, ros_message->data, ros_message->capacity);
+        if (ret) {
+          ros_message->size = strlen(ros_message->data);
+        }
+        return ret;
+      };
+    dummy_type_support.callbacks.get_serialized_size =
+      [](const void * untyped_ros_message) -> uint32_t
+      {
+        const rosidl_runtime_c__String * ros_message =
+          reinterpret_cast<const rosidl_runtime_c__String *>(untyped_ros_message);
+
+        return (uint32_t)(MICROXRCEDDS_PADDING + ros_message->size + 1);
+      };
+    dummy_type_support.callbacks.max_serialized_size = []() -> size_t
+      {
+        return (size_t)(MICROXRCEDDS_PADDING + ucdr_alignment(0, MICROXRCEDDS_PADDING) + 1);
+      };
+
+    serialized_message = rmw_get_zero_initialized_serialized_message();
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(rmw_serialized_message_init(&serialized_message, 0, &allocator), RMW_RET_OK);
+  }
+
+  void TearDown() override
+  {
+    ASSERT_EQ(rmw_serialized_message_fini(&serialized_message), RMW_RET_OK);
+  }
+
+  dummy_type_support_t dummy_type_support;
+  rmw_serialized_message_t serialized_message;
+};
+
+/*
+ * Testing a serialize and deserialize round trip.
+ */
+TEST_F(TestSerialize, round_trip)
+{
+  char content[] = "Serialized message";
+  rosidl_runtime_c__String ros_message;
+  ros_message.data = content;
+  ros_message.capacity = strlen(ros_message.data);
+  ros_message.size = ros_message.capacity;
+
+  ASSERT_EQ(
+    rmw_serialize(&ros_message, &dummy_type_support.type_support, &serialized_message),
+    RMW_RET_OK);
+  ASSERT_EQ(
+    serialized_message.buffer_length,
+    dummy_type_support.callbacks.get_serialized_size(&ros_message));
+
+  char buff[100];
+  rosidl_runtime_c__String read_ros_message;
+  read_ros_message.data = buff;
+  read_ros_message.capacity = sizeof(buff);
+  read_ros_message.size = 0;
+
+  ASSERT_EQ(
+    rmw_deserialize(&serialized_message, &dummy_type_support.type_support, &read_ros_message),
+    RMW_RET_OK);
+  ASSERT_EQ(strcmp(content, read_ros_message.data), 0);
+  ASSERT_EQ(ros_message.size, read_ros_message.size);
+
+  // A large enough buffer is reused
+  uint8_t * buffer = serialized_message.buffer;
+  ros_message.data[4] = '\0';
+  ros_message.size = 4;
+  ASSERT_EQ(
+    rmw_serialize(&ros_message, &dummy_type_support.type_support, &serialized_message),
+    RMW_RET_OK);
+  ASSERT_EQ(serialized_message.buffer, buffer);
+}
+
+/*
+ * Testing that no worst case size is reported for a type with an unbounded string.
+ */
+TEST_F(TestSerialize, serialized_message_size)
+{
+  size_t size = 0;
+  ASSERT_EQ(
+    rmw_get_serialized_message_size(&dummy_type_support.type_support, NULL, &size),
+    RMW_RET_UNSUPPORTED);
+  rmw_reset_error();
+  ASSERT_EQ(size, 0u);
+
+  // The typesupport maximum is smaller than any non empty string
+  std::string content(16, 'A');
+  rosidl_runtime_c__String ros_message;
+  ros_message.data = &content[0];
+  ros_message.capacity = content.size();
+  ros_message.size = content.size();
+  ASSERT_GT(
+    dummy_type_support.callbacks.get_serialized_size(&ros_message),
+    dummy_type_support.callbacks.max_serialized_size());
+}
+
+/*
+ * Benchmarking serialization and deserialization per message size class.
+ */
+TEST_F(TestSerialize, size_class_benchmark)
+{
+  const size_t iterations = 10000;
+  const std::vector<size_t> size_classes = {16, 256, MAX_STRING_SIZE};
+
+  std::string read_content(MAX_STRING_SIZE + 1, '\0');
+  rosidl_runtime_c__String read_ros_message;
+  read_ros_message.data = &read_content[0];
+  read_ros_message.capacity = read_content.size();
+  read_ros_message.size = 0;
+
+  fprintf(stderr, "| Payload | Serialize | Deserialize |\n");
+  fprintf(stderr, "| - | - | - |\n");
+
+  for (size_t payload : size_classes) {
+    std::string content(payload, 'A');
+    rosidl_runtime_c__String ros_message;
+    ros_message.data = &content[0];
+    ros_message.capacity = content.size();
+    ros_message.size = content.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+      ASSERT_EQ(
+        rmw_serialize(&ros_message, &dummy_type_support.type_support, &serialized_message),
+        RMW_RET_OK);
+    }
+    double serialize_ns = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / iterations;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+      ASSERT_EQ(
+        rmw_deserialize(
+          &serialized_message, &dummy_type_support.type_support, &read_ros_message),
+        RMW_RET_OK);
+    }
+    double deserialize_ns = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / iterations;
+
+    ASSERT_EQ(read_ros_message.size, payload);
+
+    fprintf(
+      stderr, "| %zu B | %.1f ns | %.1f ns |\n",
+      payload, serialize_ns, deserialize_ns);
+  }
+}
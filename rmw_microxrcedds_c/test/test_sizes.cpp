@@ -35,7 +35,8 @@ TEST_F(RMWBaseTest, estimate_default_static_memory)
   uint64_t subscription_size = sizeof(rmw_uxrce_subscription_t);
   uint64_t publisher_size = sizeof(rmw_uxrce_publisher_t);
   uint64_t node_size = sizeof(rmw_uxrce_node_t);
-  uint64_t static_input_buffer_size = sizeof(rmw_uxrce_static_input_buffer_t);
+  uint64_t static_input_arena_size =
+    RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS * sizeof(rmw_uxrce_arena_unit_t);
 
   fprintf(stderr, "# Static memory analysis \n");
   fprintf(stderr, "_**Default configuration**_\n");
@@ -46,6 +47,8 @@ TEST_F(RMWBaseTest, estimate_default_static_memory)
   fprintf(stderr, "Input history: %d\n", RMW_UXRCE_STREAM_HISTORY_INPUT);
   fprintf(stderr, "Output buffer size: %d B\n", RMW_UXRCE_MAX_OUTPUT_BUFFER_SIZE);
   fprintf(stderr, "Output history: %d\n", RMW_UXRCE_STREAM_HISTORY_OUTPUT);
+  fprintf(stderr, "Reliable output streams: %d\n", RMW_UXRCE_RELIABLE_OUTPUT_STREAMS);
+  fprintf(stderr, "Best effort output streams: %d\n", RMW_UXRCE_BEST_EFFORT_OUTPUT_STREAMS);
   fprintf(stderr, "\n");
 
   fprintf(stderr, "| Entity | Qty | Size per unit |\n");
@@ -59,9 +62,7 @@ TEST_F(RMWBaseTest, estimate_default_static_memory)
     subscription_size);
   fprintf(stderr, "| Publisher | %d | %ld B | \n", RMW_UXRCE_MAX_PUBLISHERS, publisher_size);
   fprintf(stderr, "| Node | %d | %ld B | \n", RMW_UXRCE_MAX_NODES, node_size);
-  fprintf(
-    stderr, "| Static input buffer | %d | %ld B | \n", RMW_UXRCE_MAX_HISTORY,
-    static_input_buffer_size);
+  fprintf(stderr, "| Static input buffer arena | 1 | %ld B | \n", static_input_arena_size);
 
   uint64_t total = RMW_UXRCE_MAX_SESSIONS * context_size +
     RMW_UXRCE_MAX_TOPICS_INTERNAL * topic_size +
@@ -70,8 +71,51 @@ TEST_F(RMWBaseTest, estimate_default_static_memory)
     RMW_UXRCE_MAX_SUBSCRIPTIONS * subscription_size +
     RMW_UXRCE_MAX_PUBLISHERS * publisher_size +
     RMW_UXRCE_MAX_NODES * node_size +
-    RMW_UXRCE_MAX_HISTORY * static_input_buffer_size;
+    static_input_arena_size;
 
   fprintf(stderr, "\n");
   fprintf(stderr, "**TOTAL: %ld B**\n", total);
 }
+
+TEST_F(RMWBaseTest, estimate_pool_overhead)
+{
+  const size_t pool_sizes[] = {
+    RMW_UXRCE_MAX_SESSIONS, RMW_UXRCE_MAX_NODES, RMW_UXRCE_MAX_PUBLISHERS + RMW_UXRCE_MAX_NODES,
+    RMW_UXRCE_MAX_SUBSCRIPTIONS, RMW_UXRCE_MAX_SERVICES, RMW_UXRCE_MAX_CLIENTS,
+    RMW_UXRCE_MAX_TOPICS_INTERNAL};
+
+  uint64_t total = 0;
+  for (size_t size : pool_sizes) {
+    total += sizeof(rmw_uxrce_mempool_t) + size * sizeof(rmw_uxrce_mempool_item_t) +
+      RMW_UXRCE_MEMPOOL_OCCUPANCY_WORDS(size) * sizeof(uint32_t);
+  }
+
+  fprintf(stderr, "# Memory pool overhead \n");
+  fprintf(stderr, "Pool: %ld B\n", sizeof(rmw_uxrce_mempool_t));
+  fprintf(stderr, "Item: %ld B\n", sizeof(rmw_uxrce_mempool_item_t));
+  fprintf(stderr, "\n");
+  fprintf(stderr, "**TOTAL: %ld B**\n", total);
+}
+
+TEST_F(RMWBaseTest, estimate_static_input_arena_capacity)
+{
+  const size_t message_sizes[] = {20, 64, 256, 1024, RMW_UXRCE_MAX_INPUT_BUFFER_SIZE};
+  const size_t static_input_arena_size =
+    RMW_UXRCE_STATIC_INPUT_BUFFER_ARENA_UNITS * sizeof(rmw_uxrce_arena_unit_t);
+
+  fprintf(stderr, "# Static input buffer arena \n");
+  fprintf(stderr, "Arena size: %ld B\n", static_input_arena_size);
+  fprintf(stderr, "\n");
+
+  fprintf(stderr, "| Message size | Size per sample | Queued samples |\n");
+  fprintf(stderr, "| - | - | - |\n");
+
+  for (size_t message_size : message_sizes) {
+    size_t sample_size = sizeof(rmw_uxrce_arena_unit_t) * RMW_UXRCE_ARENA_BLOCK_UNITS(
+      sizeof(rmw_uxrce_static_input_buffer_t) + message_size);
+    size_t capacity = static_input_arena_size / sample_size;
+
+    ASSERT_GE(capacity, static_cast<size_t>(RMW_UXRCE_MAX_HISTORY));
+    fprintf(stderr, "| %ld B | %ld B | %ld |\n", message_size, sample_size, capacity);
+  }
+}
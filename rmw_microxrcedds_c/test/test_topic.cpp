@@ -18,6 +18,7 @@
 #include <rmw/validate_node_name.h>
 #include <rmw_microxrcedds_c/config.h>
 #include <rmw_microxrcedds_topic.h>
+#include <utils.h>
 
 #include <vector>
 #include <memory>
@@ -70,12 +71,25 @@ TEST_F(TestTopic, construction_and_destruction)
   rmw_qos_profile_t dummy_qos_policies;
   ConfigureDefaultQOSPolices(&dummy_qos_policies);
 
+  rmw_uxrce_node_t * custom_node = reinterpret_cast<struct rmw_uxrce_node_t *>(node->data);
+  uint16_t topic_req;
+  bool topic_reused;
+  uint8_t topic_status;
   rmw_uxrce_topic_t * topic = create_topic(
-    reinterpret_cast<struct rmw_uxrce_node_t *>(node->data),
+    custom_node,
     package_name,
     &dummy_type_support.callbacks,
-    &dummy_qos_policies);
+    &dummy_qos_policies,
+    &topic_req,
+    &topic_reused);
   ASSERT_NE((void *)topic, (void *)NULL);
+  ASSERT_FALSE(topic_reused);
+
+  // Topic creation is only requested, its status is awaited by the caller
+  ASSERT_TRUE(
+    uxr_run_session_until_all_status(
+      &custom_node->context->session, RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT,
+      &topic_req, &topic_status, 1));
 
   // TODO(pablogs9): Topic must be related to publisher in order to be counted
   // ASSERT_EQ(topic_count(reinterpret_cast<struct rmw_uxrce_node_t *>(node->data)), 1);
@@ -106,13 +120,23 @@ TEST_F(TestTopic, multiple_topic_creation)
       id_gen++,
       &dummy_type_supports.back());
 
+    rmw_uxrce_node_t * custom_node = reinterpret_cast<struct rmw_uxrce_node_t *>(node->data);
+    uint16_t topic_req;
+    bool topic_reused;
+    uint8_t topic_status;
     rmw_uxrce_topic_t * created_topic = create_topic(
-      reinterpret_cast<struct rmw_uxrce_node_t *>(node->data),
+      custom_node,
       dummy_type_supports.back().topic_name.data(),
       &dummy_type_supports.back().callbacks,
-      &dummy_qos_policies);
+      &dummy_qos_policies,
+      &topic_req,
+      &topic_reused);
 
     ASSERT_NE((void *)created_topic, (void *)NULL);
+    ASSERT_TRUE(
+      uxr_run_session_until_all_status(
+        &custom_node->context->session, RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT,
+        &topic_req, &topic_status, 1));
     // TODO(pablogs9): Topic must be related to publisher in order to be counted
     // ASSERT_EQ(topic_count(reinterpret_cast<struct rmw_uxrce_node_t *>(node->data)), i + 1);
 
@@ -133,3 +157,201 @@ TEST_F(TestTopic, multiple_topic_creation)
   // TODO(pablogs9): Topic must be related to publisher in order to be counted
   // ASSERT_EQ(topic_count(reinterpret_cast<struct rmw_uxrce_node_t *>(node->data)), 0);
 }
+
+/*
+ * Testing topic reuse among endpoints of the same node, name and type
+ */
+TEST_F(TestTopic, shared_topic)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    package_name,
+    id_gen++,
+    &dummy_type_support);
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_uxrce_node_t * custom_node = reinterpret_cast<struct rmw_uxrce_node_t *>(node->data);
+  uint16_t topic_req;
+  bool topic_reused;
+  uint8_t topic_status;
+  rmw_uxrce_topic_t * topic = create_topic(
+    custom_node,
+    dummy_type_support.topic_name.data(),
+    &dummy_type_support.callbacks,
+    &dummy_qos_policies,
+    &topic_req,
+    &topic_reused);
+  ASSERT_NE((void *)topic, (void *)NULL);
+  ASSERT_FALSE(topic_reused);
+  ASSERT_TRUE(
+    uxr_run_session_until_all_status(
+      &custom_node->context->session, RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT,
+      &topic_req, &topic_status, 1));
+
+  // Same name and type, no new request
+  rmw_uxrce_topic_t * shared_topic = create_topic(
+    custom_node,
+    dummy_type_support.topic_name.data(),
+    &dummy_type_support.callbacks,
+    &dummy_qos_policies,
+    &topic_req,
+    &topic_reused);
+  ASSERT_EQ((void *)shared_topic, (void *)topic);
+  ASSERT_TRUE(topic_reused);
+  ASSERT_EQ(topic_req, UXR_INVALID_REQUEST_ID);
+
+  // Same name and another type
+  dummy_type_support_t other_type_support;
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    package_name,
+    id_gen++,
+    &other_type_support);
+
+  rmw_uxrce_topic_t * other_topic = create_topic(
+    custom_node,
+    dummy_type_support.topic_name.data(),
+    &other_type_support.callbacks,
+    &dummy_qos_policies,
+    &topic_req,
+    &topic_reused);
+  ASSERT_NE((void *)other_topic, (void *)NULL);
+  ASSERT_NE((void *)other_topic, (void *)topic);
+  ASSERT_FALSE(topic_reused);
+  ASSERT_TRUE(
+    uxr_run_session_until_all_status(
+      &custom_node->context->session, RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT,
+      &topic_req, &topic_status, 1));
+
+  // The topic is deleted along with its last user
+  ASSERT_EQ(destroy_topic(other_topic), RMW_RET_OK);
+  ASSERT_EQ(destroy_topic(shared_topic), RMW_RET_OK);
+  ASSERT_EQ(topic->owner_node, custom_node);
+  ASSERT_EQ(destroy_topic(topic), RMW_RET_OK);
+  ASSERT_EQ(destroy_topic(topic), RMW_RET_ERROR);
+}
+
+/*
+ * Testing topic names up to the maximum length
+ */
+TEST_F(TestTopic, topic_name_max_length)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    package_name,
+    id_gen++,
+    &dummy_type_support);
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  rmw_uxrce_node_t * custom_node = reinterpret_cast<struct rmw_uxrce_node_t *>(node->data);
+  uint16_t topic_req;
+  bool topic_reused;
+  uint8_t topic_status;
+
+  std::string long_name = "/" + std::string(RMW_UXRCE_TOPIC_NAME_MAX_LENGTH - 1, 'a');
+  rmw_uxrce_topic_t * topic = create_topic(
+    custom_node,
+    long_name.c_str(),
+    &dummy_type_support.callbacks,
+    &dummy_qos_policies,
+    &topic_req,
+    &topic_reused);
+  ASSERT_NE((void *)topic, (void *)NULL);
+  ASSERT_STREQ(topic->topic_name, long_name.c_str());
+  ASSERT_TRUE(
+    uxr_run_session_until_all_status(
+      &custom_node->context->session, RMW_UXRCE_ENTITY_CREATION_DESTROY_TIMEOUT,
+      &topic_req, &topic_status, 1));
+
+  // The same name is found again when shared
+  rmw_uxrce_topic_t * shared_topic = create_topic(
+    custom_node,
+    long_name.c_str(),
+    &dummy_type_support.callbacks,
+    &dummy_qos_policies,
+    &topic_req,
+    &topic_reused);
+  ASSERT_EQ((void *)shared_topic, (void *)topic);
+  ASSERT_TRUE(topic_reused);
+
+  long_name += "a";
+  rmw_uxrce_topic_t * too_long_topic = create_topic(
+    custom_node,
+    long_name.c_str(),
+    &dummy_type_support.callbacks,
+    &dummy_qos_policies,
+    &topic_req,
+    &topic_reused);
+  ASSERT_EQ((void *)too_long_topic, (void *)NULL);
+  rmw_reset_error();
+
+  ASSERT_EQ(destroy_topic(shared_topic), RMW_RET_OK);
+  ASSERT_EQ(destroy_topic(topic), RMW_RET_OK);
+}
+
+/*
+ * Testing type names computed once per type support
+ */
+TEST_F(TestTopic, type_name_table)
+{
+  dummy_type_support_t dummy_type_support;
+
+  ConfigureDummyTypeSupport(
+    topic_type,
+    topic_type,
+    package_name,
+    id_gen++,
+    &dummy_type_support);
+
+  char expected[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  generate_type_name(&dummy_type_support.callbacks, expected, sizeof(expected));
+
+  char buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  const char * type_name = get_type_name(&dummy_type_support.callbacks, buffer, sizeof(buffer));
+  ASSERT_STREQ(type_name, expected);
+  ASSERT_NE(type_name, buffer);
+
+  // Later lookups return the same interned string
+  ASSERT_EQ(get_type_name(&dummy_type_support.callbacks, buffer, sizeof(buffer)), type_name);
+}
+
+/*
+ * Testing that type names which do not fit are neither interned nor used
+ */
+TEST_F(TestTopic, type_name_too_long)
+{
+  dummy_type_support_t dummy_type_support;
+  std::string long_type(RMW_UXRCE_TYPE_NAME_MAX_LENGTH, 't');
+
+  ConfigureDummyTypeSupport(
+    long_type.c_str(),
+    topic_type,
+    package_name,
+    id_gen++,
+    &dummy_type_support);
+
+  char buffer[RMW_UXRCE_TYPE_NAME_MAX_LENGTH];
+  ASSERT_EQ(get_type_name(&dummy_type_support.callbacks, buffer, sizeof(buffer)), nullptr);
+  ASSERT_EQ(get_type_name(&dummy_type_support.callbacks, buffer, sizeof(buffer)), nullptr);
+
+  rmw_qos_profile_t dummy_qos_policies;
+  ConfigureDefaultQOSPolices(&dummy_qos_policies);
+
+  // Entity creation fails instead of using a truncated name
+  char xml[RMW_UXRCE_ENTITY_NAMING_BUFFER_LENGTH];
+  ASSERT_EQ(
+    build_topic_xml(
+      dummy_type_support.topic_name.data(), &dummy_type_support.callbacks,
+      &dummy_qos_policies, xml, sizeof(xml)), 0);
+}